@@ -0,0 +1,6 @@
+// this file is automatically generated by mkconfig.sh
+#define CONFIG_TARGET "testing-par"
+#define CONFIG_DATE "17-Oct-2026 14:55"
+#define CONFIG_BRANCH "master"
+#define CONFIG_REVISION "0a2367991d82986f54548c13c908298d39e6da6b"
+#define CONFIG_DIRTY
@@ -0,0 +1,68 @@
+#!/bin/bash
+
+# builds satUZK-seq with different PROPAGATE_FLAGS and compares their speed.
+# all variants perform the same search, so the number of propagations per
+# second of wall time can be compared directly.
+# usage: ./bench.sh <prefetch|var-record> <instance>...
+
+if [ $# -lt 2 ]
+then
+	echo "usage: $0 <prefetch|var-record> <instance>..."
+	exit 1
+fi
+
+case "$1" in
+prefetch)
+	variants=("" "-DFEATURE_WATCH_PREFETCH -DWATCH_PREFETCH_DISTANCE=2"
+		"-DFEATURE_WATCH_PREFETCH -DWATCH_PREFETCH_DISTANCE=4"
+		"-DFEATURE_WATCH_PREFETCH -DWATCH_PREFETCH_DISTANCE=8"
+		"-DFEATURE_WATCH_PREFETCH -DWATCH_PREFETCH_DISTANCE=16")
+	;;
+var-record)
+	variants=("" "-DFEATURE_VAR_RECORD")
+	;;
+*)
+	echo "Unknown benchmark $1"
+	exit 1
+	;;
+esac
+shift
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+for i in "${!variants[@]}"
+do
+	echo "c building variant $i: ${variants[$i]:-(default)}"
+	if ! make testing PROPAGATE_FLAGS="${variants[$i]}" SEQ_BINARY="$dir/seq-$i" \
+			CPP_ADDS="$CPP_ADDS" > "$dir/build-$i.log" 2>&1
+	then
+		cat "$dir/build-$i.log"
+		exit 1
+	fi
+done
+
+# each instance is solved runs times per variant; the fastest run counts
+runs=3
+
+printf "%-24s %-8s %14s %14s\n" instance variant propagations props/sec
+for instance in "$@"
+do
+	for i in "${!variants[@]}"
+	do
+		best=0
+		for run in $(seq $runs)
+		do
+			start=$(date +%s%N)
+			props=$("$dir/seq-$i" -seed 1 "$instance" \
+					| sed -n 's/^c *propagations: \([0-9]*\).*/\1/p')
+			elapsed=$(( $(date +%s%N) - start ))
+			speed=$(( props * 1000000000 / elapsed ))
+			if [ $speed -gt $best ]
+			then
+				best=$speed
+			fi
+		done
+		printf "%-24s %-8s %14s %14s\n" "$(basename "$instance")" "$i" "$props" "$best"
+	done
+done
@@ -17,6 +17,7 @@ public:
 	static AntecedentStruct<BaseDefs> makeDecision();
 	static AntecedentStruct<BaseDefs> makeClause(Clause clause);
 	static AntecedentStruct<BaseDefs> makeBinary(Literal literal);
+	static AntecedentStruct<BaseDefs> makeTernary(Literal literal1, Literal literal2);
 
 	bool operator== (AntecedentStruct<BaseDefs> other);
 	bool operator!= (AntecedentStruct<BaseDefs> other);
@@ -24,20 +25,27 @@ public:
 	bool isDecision();
 	bool isClause();
 	bool isBinary();
+	bool isTernary();
 
 	Clause getClause();
 	Literal getBinary();
+	Literal getLiteral1();
+	Literal getLiteral2();
 
 private:
 	static const uint32_t kTypeNone = 0;
 	static const uint32_t kTypeDecision = 1;
 	static const uint32_t kTypeClause = 2;
 	static const uint32_t kTypeBinary = 3;
+	/* ternary antecedents store their first literal in place of the type.
+	 * the most significant bit is free as only literals that fit into
+	 * ternary watch list entries are stored */
+	static const uint32_t kTypeTernary = (uint32_t)1 << 31;
 	
 	uint32_t type;
 
 	union {
-		uint32_t padding;
+		typename BaseDefs::ClauseIndex padding;
 		typename BaseDefs::ClauseIndex clause;
 		typename BaseDefs::LiteralIndex literal;
 	} identifier;
@@ -59,6 +67,8 @@ public:
 			typename Config::Antecedent antecedent) {
 		if(antecedent.isBinary()) {
 			return AntecedentIteratorStruct(config, antecedent, 1);
+		}else if(antecedent.isTernary()) {
+			return AntecedentIteratorStruct(config, antecedent, 2);
 		}else if(antecedent.isClause()) {
 			typename Config::Clause clause = antecedent.getClause();
 			return AntecedentIteratorStruct(config, antecedent,
@@ -81,6 +91,9 @@ public:
 		if(p_antecedent.isBinary()) {
 			SYS_ASSERT(SYS_ASRT_GENERAL, p_index == 0);
 			return p_antecedent.getBinary();
+		}else if(p_antecedent.isTernary()) {
+			SYS_ASSERT(SYS_ASRT_GENERAL, p_index < 2);
+			return p_index == 0 ? p_antecedent.getLiteral1() : p_antecedent.getLiteral2();
 		}else if(p_antecedent.isClause()) {
 			typename Config::Clause clause = p_antecedent.getClause();
 			return p_config.clauseGetLiteral(clause, p_index + 1).inverse();
@@ -45,6 +45,18 @@ public:
 	typedef typename BaseDefs::Declevel Declevel;
 
 	static const int kClauseAlignment = 8;
+	// learned clauses up to this lbd are moved to the old clause arena
+	static const unsigned int kPromoteLbd = 2;
+
+	/* levels of memory pressure returned by memoryPressure().
+	 * each level enables the measures of the lower levels */
+	// clauses are reduced more frequently
+	static const int kPressureLow = 1;
+	// clauses are deleted instead of frozen; garbage is collected early;
+	// clauses imported from other threads are dropped
+	static const int kPressureHigh = 2;
+	// frozen clauses are deleted, too
+	static const int kPressureCritical = 3;
 
 	typedef Config<BaseDefs, Hooks> ThisType;
 
@@ -54,6 +66,7 @@ public:
 public:
 	typedef VarConfigStruct<BaseDefs> VarConfig;
 	typedef ClauseSpaceStruct<BaseDefs> ClauseConfig;
+	typedef ClauseForwardingStruct<BaseDefs> ClauseForwarding;
 
 	typedef uint64_t ClauseSignature;
 
@@ -80,12 +93,15 @@ public:
 			maintainOcclists(false),
 			conflictNum(0),
 			currentAssignedVars(0),
-			currentActiveClauses(0), currentEssentialClauses(0) {
+			currentActiveClauses(0), currentEssentialClauses(0),
+			p_proofWriter(nullptr), p_lastClauseId(0) {
 		/* allocate memory for clauses */
 		uint32_t clause_memsize = 4 * 1024 * 1024;
 //		std::cout << "c [GC    ] Initial clause space: " << (clause_memsize / 1024) << " kb" << std::endl;
-		void *memory = operator new(clause_memsize);
-		p_clauseConfig.p_allocator.initMemory(memory, clause_memsize);
+		for(int i = 0; i < ClauseConfig::kNumArenas; i++) {
+			void *memory = sysPageAllocate(clause_memsize);
+			p_clauseConfig.p_arenas[i].allocator.initMemory(memory, clause_memsize);
+		}
 
 		p_rndEngine.seed(0x12345678);
 		
@@ -110,7 +126,9 @@ public:
 
 	~Config() {
 		delete[] state.restart.glucoseShortBuffer;
-		operator delete(p_clauseConfig.p_allocator.getPointer());
+		for(int i = 0; i < ClauseConfig::kNumArenas; i++)
+			sysPageDeallocate(p_clauseConfig.p_arenas[i].allocator.getPointer(),
+					p_clauseConfig.p_arenas[i].allocator.getTotalSpace());
 	}
 
 	Config(const Config &) = delete;
@@ -208,12 +226,15 @@ public:
 	bool clauseContains(Clause clause, Literal literal);
 	int clausePolarity(Clause clause, Variable variable);
 
-	/* make sure there is enough space to store clauses.
-	 * move the whole clause space if there is not. */
-	void ensureClauseSpace(unsigned int free_required);
+	/* make sure there is enough space to store clauses in the given arena.
+	 * move the whole arena if there is not. */
+	void ensureClauseSpace(int arena, uint64_t free_required);
+	// returns the desired size of an arena capped to the range of clause indices
+	uint64_t limitClauseSpace(uint64_t required, uint64_t desired);
 	
-	unsigned int usedClauseSpace() {
-		return p_clauseConfig.p_allocator.getUsedSpace();
+	uint64_t usedClauseSpace() {
+		return p_clauseConfig.p_arenas[ClauseConfig::kArenaOld].allocator.getUsedSpace()
+				+ p_clauseConfig.p_arenas[ClauseConfig::kArenaYoung].allocator.getUsedSpace();
 	}
 
 	ClauseIterator clausesBegin() {
@@ -245,11 +266,12 @@ public:
 	ClauseLitIterator clauseBegin3(Clause clause);
 	ClauseLitIterator clauseEnd(Clause clause);
 
-	void clauseSetFirst(Clause clause, Literal literal) {
-		p_clauseConfig.clauseSetLiteral(clause, 0, literal);
+	void clauseSwapWatched(Clause clause) {
+		p_clauseConfig.clauseSwapWatched(clause);
 	}
-	void clauseSetSecond(Clause clause, Literal literal) {
-		p_clauseConfig.clauseSetLiteral(clause, 1, literal);
+	// watches the literal returned by clauseFindWatch() instead of the second one
+	void clauseWatchSecond(Clause clause, Literal *replacement) {
+		p_clauseConfig.clauseWatchSecond(clause, replacement);
 	}
 
 	Literal clauseGetLiteral(Clause clause, ClauseLitIndex index) {
@@ -261,6 +283,12 @@ public:
 	Literal clauseGetSecond(Clause clause) {
 		return p_clauseConfig.clauseGetLiteral(clause, 1);
 	}
+	void clausePrefetch(Clause clause) {
+		p_clauseConfig.clausePrefetch(clause);
+	}
+	// returns a literal at position >= 2 that is not false or NULL
+	Literal *clauseFindWatch(Clause clause);
+	Literal *sharedFindWatch(Clause clause);
 
 	void clauseSetEssential(Clause clause);
 	void clauseUnsetEssential(Clause clause);
@@ -276,6 +304,17 @@ public:
 	bool clauseAssigned(Clause clause);
 	// returns true if the clause is currently the antecedent of a variable
 	bool clauseIsAntecedent(Clause clause);
+	// returns true if the clause is the antecedent of the given variable
+	bool varImpliedBy(Variable var, Clause clause);
+	// returns true if the clause is watched by ternary watch list entries
+	bool clauseIsTernary(Clause clause) {
+		return p_clauseConfig.getFlagTernary(clause);
+	}
+	/* returns true if installClause() should watch the clause by ternary
+	 * entries. their antecedents do not reference the clause so that it
+	 * never gets bumped. only essential clauses qualify as they are never
+	 * reduced; learned ternary clauses are watched like long clauses */
+	bool clauseFitsTernary(Clause clause);
 	
 	unsigned int clauseGetLbd(Clause clause) {
 		return p_clauseConfig.clauseGetLbd(clause);
@@ -293,6 +332,10 @@ public:
 		p_clauseConfig.clauseSetActivity(clause, activity);
 	}
 
+	uint64_t clauseGetId(Clause clause) {
+		return p_clauseConfig.clauseGetId(clause);
+	}
+
 	ClauseSignature clauseGetSignature(Clause clause) {
 		return p_clauseConfig.clauseGetSignature(clause);
 	}
@@ -300,16 +343,24 @@ public:
 		p_clauseConfig.clauseSetSignature(clause, signature);
 	}
 
-	// use a copying-garbage collection to get rid of deleted clauses
-	void collectClauses();
+	// use a sliding garbage collection to get rid of deleted clauses in an arena
+	void collectClauses(int arena);
+	/* helper function for collectClauses(). copies the clauses of an arena
+	 * to fresh memory in the order in which propagation visits them */
+	void layoutClauses(int arena);
 
 	/* helper function for collectClauses().
-	 * Called when a clause is moved. Updates watch lists etc. */
-	void onClauseMove(Clause from_index, Clause to_index);
+	 * Called before the clauses are moved. Updates watch lists etc. */
+	void forwardClauses(ClauseForwarding &forwarding);
 	
 	// checks whether a garbage collection is necessary
 	void checkClauseGarbage();
 
+	// bytes used by the clause arenas, the clause metadata and the watch lists
+	uint64_t memoryUsage();
+	// returns one of the kPressure... levels or 0 if there is no memory limit
+	int memoryPressure();
+
 	// removes all learned (i.e. not essential) clauses
 	void expellLearned();
 	// removes all clauses containing the specified literal
@@ -326,19 +377,29 @@ public:
 	void watchCut(Literal literal, WatchIterator iterator) {
 		return p_varConfig.watchCut(literal, iterator);
 	}
+	WatchIterator binaryBegin(Literal literal) {
+		return p_varConfig.binaryBegin(literal);
+	}
+	WatchIterator binaryEnd(Literal literal) {
+		return p_varConfig.binaryEnd(literal);
+	}
 	
 	// helper functions to manipulate watch lists
 	void watchInsertClause(Literal literal, Literal blocking, Clause clause);
 	void watchInsertBinary(Literal literal, Literal implied, Clause clause);
+	void watchInsertTernary(Literal literal, Literal first, Literal second);
 	
 	// helper functions to manipulate watch lists
 	void watchRemoveClause(Literal literal, Clause clause);
 	void watchRemoveBinary(Literal literal, Clause clause);
+	void watchRemoveTernary(Literal literal, Literal first, Literal second);
 	
 	void watchReplaceClause(Literal literal, Clause clause, Clause replacement);
 	void watchReplaceBinary(Literal literal, Clause clause, Clause replacement);
 	//TODO: do we need this?
 	bool watchContainsBinary(Literal literal, Literal implied);
+	// returns the binary clause that implies a literal if another literal is true
+	Clause watchFindBinary(Literal literal, Literal implied);
 
 	void occurConstruct();
 	void occurDestruct();
@@ -404,17 +465,30 @@ public:
 	
 	/* ------------------------ INPUT FUNCTIONS ---------------------------- */
 	template<typename Iterator>
-	void inputClause(ClauseLitIndex length, Iterator begin, Iterator end);
+	Clause inputClause(ClauseLitIndex length, Iterator begin, Iterator end);
+	/* inputs many clauses at once: clause i consists of the literal indices
+	 * literals[offsets[i]] ... literals[offsets[i + 1] - 1] */
+	void inputBulk(uint64_t num_clauses, const uint64_t *offsets,
+			const typename BaseDefs::LiteralIndex *literals);
+	/* like inputBulk() but long clauses are not copied and refer to the
+	 * literals instead. the literals must not change until this configuration
+	 * is destroyed. short clauses are copied as they take less space
+	 * than a reference */
+	void inputShared(uint64_t num_clauses, const uint64_t *offsets,
+			typename BaseDefs::LiteralIndex *literals);
+	// skips the id of an input clause that was dropped by the parser
+	void inputSkip();
 	
 	void inputFinish();
 
 	/* --------------- CLAUSE REDUCTIONS FUNCTIONS ------------------------- */
 	
-	// sets the frozen flag and uninstalls the clause
+	// sets the frozen flag, uninstalls the clause and packs its literals
 	void freezeClause(Clause clause);
-	// sets the frozen flag for clauses that are currently not installed
+	// like freezeClause() for clauses that are currently not installed
 	void quickFreezeClause(Clause clause);
-	void unfreezeClause(Clause clause);
+	// the clause is moved to a new index which is returned
+	Clause unfreezeClause(Clause clause);
 	bool clauseIsFrozen(Clause clause);
 
 	int calculatePsm(Clause clause);
@@ -467,6 +541,18 @@ public:
 	// resolves the conflict
 	void resolveConflict();
 
+	/* ------------------------ PROOF FUNCTIONS ---------------------------- */
+
+	bool lratEnabled() {
+		return p_proofWriter != nullptr && p_proofWriter->isLrat();
+	}
+	// returns the id of the clause that implied the assignment of a variable
+	uint64_t antecedentId(Variable var);
+	// returns the id of the clause that caused the current conflict
+	uint64_t conflictId();
+	// writes the empty clause after the solver found a conflict at level 1
+	void proofEmptyClause();
+
 	/* --------------------- ASSUMPTION FUNCTIONS -------------------------- */
 	void assumptionEnable(Literal literal);
 	void assumptionDisable(Literal literal);
@@ -477,13 +563,14 @@ public:
 	/* allocates a clause and fills it with the given literals.
 		NOTE: does NOT install watched literal etc. */
 	template<typename Iterator>
-	Clause allocClause(ClauseLitIndex length, Iterator begin, Iterator end);
+	Clause allocClause(ClauseLitIndex length, Iterator begin, Iterator end,
+			int arena = ClauseConfig::kArenaYoung);
 
 	void deleteClause(Clause clause);
 
 	/* -------------- INSTALL / UNINSTALL FUNCTIONS ------------------------ */
 	/* invalidates watch list iterators for the *inverses* of
-	 *     the first two literals of the clause.
+	 *     the first two literals of the clause (all literals of ternary clauses).
 	 * invalidates occlist iterators for all literals of the clause. */
 	void installClause(Clause clause);
 	void uninstallClause(Clause clause);
@@ -602,6 +689,14 @@ public:
 	uint32_t currentEssentialClauses;
 
 	sys::Reporter p_reporter;
+	// receives the drat proof if it is not null
+	sys::ProofWriter *p_proofWriter;
+	// id of the last clause that was allocated
+	uint64_t p_lastClauseId;
+	// ids of the unit clauses indexed by literal
+	std::vector<uint64_t> p_unitIds;
+	// hints of the current lrat proof step
+	std::vector<uint64_t> p_lratHints;
 
 	const bool kReportEnable = false;
 	const bool kReportAssign = false, kReportSample = false, kReportReducerSample = false;
@@ -630,13 +725,18 @@ public:
 		struct StatGeneral {
 			uint32_t clauseReallocs;
 			uint32_t clauseCollects;
+			uint32_t watchCompacts;
 			
 			uint64_t deletedClauses;
+			// highest memory pressure level that was reached
+			int peakPressure;
 			
 			StatGeneral() :
 				clauseReallocs(0),
 				clauseCollects(0),
-				deletedClauses(0) { }
+				watchCompacts(0),
+				deletedClauses(0),
+				peakPressure(0) { }
 		} general;
 
 		struct StatSearch {
@@ -722,12 +822,15 @@ public:
 
 			sys::HptCounter budget;
 			sys::HptCounter timeout;
-			
-			bool outputDratProof;
+
+			// reorder the clauses during garbage collection, see layoutClauses()
+			bool layoutClauses;
+			// soft limit for memoryUsage() in bytes or 0 for no limit
+			uint64_t memLimit;
 
 			OptsGeneral() : verbose(0),
 					budget(0), timeout(0),
-					outputDratProof(false) { }
+					layoutClauses(false), memLimit(0) { }
 		} general;
 
 		struct OptsLearn {
@@ -16,6 +16,8 @@ public:
 	static ConflictStruct<BaseDefs> makeNone();
 	static ConflictStruct<BaseDefs> makeClause(Clause clause);
 	static ConflictStruct<BaseDefs> makeBinary(Literal literal1, Literal literal2);
+	static ConflictStruct<BaseDefs> makeTernary(Literal literal1, Literal literal2,
+			Literal literal3);
 	static ConflictStruct<BaseDefs> makeFact(Literal literal);
 	static ConflictStruct<BaseDefs> makeEmpty();
 
@@ -25,12 +27,14 @@ public:
 	bool isNone();
 	bool isClause();
 	bool isBinary();
+	bool isTernary();
 	bool isFact();
 	bool isEmpty();
 
 	Clause getClause();
 	Literal getLiteral1();
 	Literal getLiteral2();
+	Literal getLiteral3();
 
 private:
 	static const uint32_t kTypeNone = 0;
@@ -38,6 +42,7 @@ private:
 	static const uint32_t kTypeBinary = 2;
 	static const uint32_t kTypeFact = 3;
 	static const uint32_t kTypeEmpty = 4;
+	static const uint32_t kTypeTernary = 5;
 
 	uint32_t type;
 	
@@ -45,11 +50,13 @@ private:
 		struct {
 			uint32_t p1;
 			uint32_t p2;
+			uint32_t p3;
 		} padding;
 		typename BaseDefs::ClauseIndex clause;
 		struct {
 			typename BaseDefs::LiteralIndex l1;
 			typename BaseDefs::LiteralIndex l2;
+			typename BaseDefs::LiteralIndex l3;
 		} literals;
 	};
 };
@@ -72,6 +79,8 @@ public:
 			return ConflictIteratorStruct(config, conflict, 1);
 		}else if(conflict.isBinary()) {
 			return ConflictIteratorStruct(config, conflict, 2);
+		}else if(conflict.isTernary()) {
+			return ConflictIteratorStruct(config, conflict, 3);
 		}else if(conflict.isClause()) {
 			typename Config::Clause clause = conflict.getClause();
 			return ConflictIteratorStruct(config, conflict,
@@ -96,6 +105,11 @@ public:
 			return p_conflict.getLiteral1();
 		}else if(p_conflict.isBinary() && p_index == 1) {
 			return p_conflict.getLiteral2();
+		}else if(p_conflict.isTernary()) {
+			SYS_ASSERT(SYS_ASRT_GENERAL, p_index < 3);
+			if(p_index == 0)
+				return p_conflict.getLiteral1();
+			return p_index == 1 ? p_conflict.getLiteral2() : p_conflict.getLiteral3();
 		}else if(p_conflict.isClause()) {
 			typename Config::Clause clause = p_conflict.getClause();
 			return p_config.clauseGetLiteral(clause, p_index).inverse();
@@ -112,23 +112,36 @@ struct WatchlistEntryStruct {
 	typedef LiteralType<BaseDefs> Literal;
 	typedef ClauseType<BaseDefs> Clause;
 
-	static const uint32_t kFlagMask = 0x80000000;
-	static const uint32_t kFlagLong = 0;
-	static const uint32_t kFlagBinary = 0x80000000;
+	typedef typename BaseDefs::ClauseIndex Field1;
 
-	// stores the flags for all entries
+	/* the most significant bit of the clause index distinguishes long and
+	 * ternary entries. binary entries are kept in separate lists and
+	 * need no flag */
+	static const Field1 kFlagMask = (Field1)1 << (sizeof(Field1) * 8 - 1);
+	static const Field1 kFlagLong = 0;
+	static const Field1 kFlagTernary = kFlagMask;
+
+	// stores the flag for long and ternary entries
 	// stores the clause for binary and long entries
-	uint32_t field1;
+	// stores the first other literal for ternary entries
+	Field1 field1;
 	// stores the implied literal for binary entries
 	// stores the blocking literal for long entries
+	// stores the second other literal for ternary entries
 	uint32_t field2;
 	
 	WatchlistEntryStruct() : field1(0), field2(0) { }
 	
+	/* checks whether a literal can be stored in a ternary entry.
+	 * ternary antecedents (see AntecedentStruct) also require the most
+	 * significant bit of the literal index to be free */
+	static bool ternaryFits(Literal literal) {
+		return !(literal.getIndex() >> (sizeof(typename BaseDefs::LiteralIndex) * 8 - 1));
+	}
+
 	void setLong();
-	void setBinary();
 	bool isLong();
-	bool isBinary();
+	bool isTernary();
 
 	void binarySetImplied(Literal literal);
 	void binarySetClause(Clause clause);
@@ -139,6 +152,11 @@ struct WatchlistEntryStruct {
 	void longSetBlocking(Literal literal);
 	Clause longGetClause();
 	Literal longGetBlocking();
+
+	// ternary entries do not reference their clause
+	void ternarySetLiterals(Literal first, Literal second);
+	Literal ternaryGetFirst();
+	Literal ternaryGetSecond();
 };
 
 template<typename BaseDefs>
@@ -146,23 +164,19 @@ class OcclistStruct {
 public:
 	typedef ClauseType<BaseDefs> Clause;
 
-	typedef util::vectors::simple<Clause> ClauseVector;
+	typedef util::vectors::pooled<Clause> ClauseVector;
 	typedef typename ClauseVector::iterator iterator;
 
 	OcclistStruct() : p_vector() { }
-	OcclistStruct(OcclistStruct &&other)
-		: p_vector(std::move(other.p_vector)) { }
-	OcclistStruct(const OcclistStruct &) = delete;
-	void operator= (const OcclistStruct &) = delete;
 
-	void insert(Clause clause) {
-		p_vector.push_back(clause);
+	void insert(util::memory::SlabAllocator &allocator, Clause clause) {
+		p_vector.push_back(allocator, clause);
 	}
 	void clear() {
 		p_vector.resize(0);
 	}
-	void shrink() {
-		p_vector.shrink_to_fit();
+	void shrink(util::memory::SlabAllocator &allocator) {
+		p_vector.shrink_to_fit(allocator);
 	}
 	void erase(iterator iterator) {
 		p_vector.erase(iterator);
@@ -190,20 +204,16 @@ class WatchlistStruct {
 public:
 	typedef WatchlistEntryStruct<BaseDefs> Entry;
 
-	typedef util::vectors::simple<Entry> EntryVector;
+	typedef util::vectors::pooled<Entry> EntryVector;
 	typedef typename EntryVector::iterator iterator;
 
 	WatchlistStruct() : p_vector() { }
-	WatchlistStruct(WatchlistStruct &&other)
-		: p_vector(std::move(other.p_vector)) { }
-	WatchlistStruct(const WatchlistStruct &) = delete;
-	void operator= (const WatchlistStruct &) = delete;
 
 	typename EntryVector::size_type size() {
 		return p_vector.size();
 	}
-	void insert(Entry entry) {
-		p_vector.push_back(entry);
+	void insert(util::memory::SlabAllocator &allocator, Entry entry) {
+		p_vector.push_back(allocator, entry);
 	}
 	void erase(iterator it) {
 		iterator end = p_vector.end();
@@ -224,6 +234,13 @@ public:
 		p_vector.clear();
 	}
 
+	/* moves the list to a new block during compaction of the allocator.
+	 * some free space is left so that the list does not move again
+	 * as soon as new entries are inserted */
+	void compact(util::memory::SlabAllocator &allocator) {
+		p_vector.relocate(allocator, p_vector.size() + p_vector.size() / 2);
+	}
+
 private:
 	EntryVector p_vector;
 };
@@ -307,11 +324,18 @@ public:
 	void reserveVars(Index count) {
 		p_assigns.reserve(count);
 		p_varflags.reserve(count);
+#ifdef FEATURE_VAR_RECORD
+		p_records.reserve(count);
+		p_escapes.reserve(count);
+#else
 		p_declevels.reserve(count);
 		p_antecedents.reserve(count);
+#endif
 
 		p_litflags.reserve(2 * count);
 		p_watchlists.reserve(2 * count);
+		p_binlists.reserve(2 * count);
+		p_watchVisits.reserve(2 * count);
 	}
 
 	Variable allocVar() {
@@ -327,16 +351,35 @@ public:
 		Flags initial_litflags2 = 0;
 		Watchlist initial_watchlist1;
 		Watchlist initial_watchlist2;
-
+		Watchlist initial_binlist1;
+		Watchlist initial_binlist2;
+
+#ifdef __AVX2__
+		// litFindNotFalse() reads up to three bytes after the last assignment
+		if(p_assigns.capacity() < p_assigns.size() + 4)
+			p_assigns.reserve(2 * p_assigns.size() + 4);
+#endif
 		p_assigns.push_back(initial_assign);
 		p_varflags.push_back(initial_flags);
+#ifdef FEATURE_VAR_RECORD
+		VarRecord initial_record;
+		initial_record.reason = kReasonNone;
+		initial_record.declevel = initial_declevel;
+		p_records.push_back(initial_record);
+		p_escapes.push_back(initial_antecedent);
+#else
 		p_declevels.push_back(initial_declevel);
 		p_antecedents.push_back(initial_antecedent);
+#endif
 
 		p_litflags.push_back(initial_litflags1);
 		p_litflags.push_back(initial_litflags2);
 		p_watchlists.emplace_back(std::move(initial_watchlist1));
 		p_watchlists.emplace_back(std::move(initial_watchlist2));
+		p_binlists.emplace_back(std::move(initial_binlist1));
+		p_binlists.emplace_back(std::move(initial_binlist2));
+		p_watchVisits.push_back(0);
+		p_watchVisits.push_back(0);
 
 		p_presentCount++;
 		return Variable::fromIndex(index);
@@ -361,6 +404,26 @@ public:
 	// assignment related functions
 	// -----------------------------------------------------------------
 	
+#ifdef FEATURE_VAR_RECORD
+	// propagation reads p_assigns; all other queries read the record
+	void assign(Variable var, bool state) {
+		p_assigns[var.getIndex()].assign(state);
+		p_records[var.getIndex()].assign.assign(state);
+	}
+	void unassign(Variable var) {
+		p_assigns[var.getIndex()].unassign();
+		p_records[var.getIndex()].assign.unassign();
+	}
+	bool isAssigned(Variable var) {
+		return p_records[var.getIndex()].assign.isAssigned();
+	}
+	bool isAssignedOne(Variable var) {
+		return p_records[var.getIndex()].assign.isOne();
+	}
+	bool isAssignedZero(Variable var) {
+		return p_records[var.getIndex()].assign.isZero();
+	}
+#else
 	void assign(Variable var, bool state) {
 		p_assigns[var.getIndex()].assign(state);
 	}
@@ -376,6 +439,7 @@ public:
 	bool isAssignedZero(Variable var) {
 		return p_assigns[var.getIndex()].isZero();
 	}
+#endif
 	bool litIsTrue(Literal literal) {
 		Variable var = literal.variable();
 		return p_assigns[var.getIndex()].litIsTrue(literal);
@@ -384,7 +448,47 @@ public:
 		Variable var = literal.variable();
 		return p_assigns[var.getIndex()].litIsFalse(literal);
 	}
+	// returns the first literal in [begin, end) that is not false or end if there is none
+	Literal *litFindNotFalse(Literal *begin, Literal *end);
 	
+#ifdef FEATURE_VAR_RECORD
+	Declevel getDeclevel(Variable var) {
+		return p_records[var.getIndex()].declevel;
+	}
+	void setDeclevel(Variable var, Declevel declevel) {
+		p_records[var.getIndex()].declevel = declevel;
+	}
+	Antecedent getAntecedent(Variable var) {
+		uint32_t reason = p_records[var.getIndex()].reason;
+		switch(reason & kReasonTagMask) {
+		case kReasonClause:
+			return Antecedent::makeClause(Clause::fromIndex(reason >> kReasonTagBits));
+		case kReasonBinary:
+			return Antecedent::makeBinary(Literal::fromIndex(reason >> kReasonTagBits));
+		case kReasonNone:
+			return reason == kReasonDecision ? Antecedent::makeDecision()
+					: Antecedent::makeNone();
+		default:
+			return p_escapes[var.getIndex()];
+		}
+	}
+	void setAntecedent(Variable var, Antecedent antecedent) {
+		uint32_t &reason = p_records[var.getIndex()].reason;
+		if(antecedent.isClause() && antecedent.getClause().getIndex() <= kReasonMaxPayload) {
+			reason = (antecedent.getClause().getIndex() << kReasonTagBits) | kReasonClause;
+		}else if(antecedent.isBinary()
+				&& antecedent.getBinary().getIndex() <= kReasonMaxPayload) {
+			reason = (antecedent.getBinary().getIndex() << kReasonTagBits) | kReasonBinary;
+		}else if(antecedent.isDecision()) {
+			reason = kReasonDecision;
+		}else if(antecedent == Antecedent::makeNone()) {
+			reason = kReasonNone;
+		}else{
+			p_escapes[var.getIndex()] = antecedent;
+			reason = kReasonEscape;
+		}
+	}
+#else
 	Declevel getDeclevel(Variable var) {
 		return p_declevels[var.getIndex()];
 	}
@@ -397,6 +501,7 @@ public:
 	void setAntecedent(Variable var, Antecedent antecedent) {
 		p_antecedents[var.getIndex()] = antecedent;
 	}
+#endif
 
 	// -----------------------------------------------------------------
 	// flag related functions
@@ -431,7 +536,7 @@ public:
 		p_occlists[literal.getIndex()].clear();
 	}
 	void occurShrink(Literal literal) {
-		p_occlists[literal.getIndex()].shrink();
+		p_occlists[literal.getIndex()].shrink(p_occurPool);
 	}
 	void occurErase(Literal literal, OccurIterator iterator) {
 		p_occlists[literal.getIndex()].erase(iterator);
@@ -458,7 +563,7 @@ public:
 	}
 	void watchInsert(Literal literal, WatchlistEntry entry) {
 		Watchlist &watchlist = p_watchlists[literal.getIndex()];
-		watchlist.insert(entry);
+		watchlist.insert(p_watchPool, entry);
 		p_watchSize++;
 	}
 	unsigned int watchSize(Literal literal) {
@@ -488,6 +593,50 @@ public:
 		p_watchSize -= watch_list.size();
 		watch_list.clear();
 	}
+	// called each time the watch list of a literal is traversed
+	void watchVisit(Literal literal) {
+		p_watchVisits[literal.getIndex()]++;
+	}
+	// memory of the watch lists including fragmentation
+	uint64_t watchMemory() {
+		return p_watchPool.getTotalSpace()
+				+ p_watchlists.size() * (2 * sizeof(Watchlist) + sizeof(uint32_t));
+	}
+	// bytes of the watch list pool that do not hold any entry
+	uint64_t watchWaste() {
+		return p_watchPool.getTotalSpace() - p_watchSize * sizeof(WatchlistEntry);
+	}
+	void watchHotOrder(std::vector<Index> &order);
+	void watchCompact();
+
+	// -----------------------------------------------------------------
+	// binary implication list related functions
+	// -----------------------------------------------------------------
+
+	// binary clauses are not stored in the watch lists but in a separate
+	// list per literal so that they can be propagated before long clauses
+	void binaryInsert(Literal literal, WatchlistEntry entry) {
+		p_binlists[literal.getIndex()].insert(p_watchPool, entry);
+		p_watchSize++;
+	}
+	unsigned int binarySize(Literal literal) {
+		return p_binlists[literal.getIndex()].size();
+	}
+	WatchIterator binaryBegin(Literal literal) {
+		return p_binlists[literal.getIndex()].begin();
+	}
+	WatchIterator binaryEnd(Literal literal) {
+		return p_binlists[literal.getIndex()].end();
+	}
+	void binaryErase(Literal literal, WatchIterator it) {
+		p_binlists[literal.getIndex()].erase(it);
+		p_watchSize--;
+	}
+	void binaryClear(Literal literal) {
+		Watchlist &bin_list = p_binlists[literal.getIndex()];
+		p_watchSize -= bin_list.size();
+		bin_list.clear();
+	}
 
 	// -----------------------------------------------------------------
 	// equivalence related functions
@@ -534,13 +683,47 @@ private:
 	// per variable configuration
 	std::vector<AssignInfo> p_assigns;
 	std::vector<Flags> p_varflags;
+#ifdef FEATURE_VAR_RECORD
+	/* conflict analysis reads the decision level and the antecedent
+	 * of a variable together. storing both in one record saves a cache miss.
+	 * p_assigns keeps a copy of the values as propagation only needs those.
+	 * the reason is a clause index or a binary literal shifted left by
+	 * two bits with a tag in the low bits. ternary antecedents and indices
+	 * that do not fit are escaped to p_escapes */
+	static const uint32_t kReasonTagBits = 2;
+	static const uint32_t kReasonTagMask = 3;
+	static const uint32_t kReasonClause = 0;
+	static const uint32_t kReasonBinary = 1;
+	static const uint32_t kReasonNone = 2;
+	static const uint32_t kReasonEscape = 3;
+	static const uint32_t kReasonDecision = (1 << kReasonTagBits) | kReasonNone;
+	static const uint64_t kReasonMaxPayload = 0xFFFFFFFFu >> kReasonTagBits;
+
+	struct VarRecord {
+		uint32_t reason;
+		Declevel declevel;
+		AssignInfo assign;
+	};
+	static_assert(sizeof(VarRecord) <= 12, "variable records must fit into 12 bytes");
+	std::vector<VarRecord> p_records;
+	std::vector<Antecedent> p_escapes;
+#else
 	std::vector<Declevel> p_declevels;
 	std::vector<Antecedent> p_antecedents;
+#endif
 	
 	// per literal configuration
 	std::vector<Flags> p_litflags;
 	std::vector<Occlist> p_occlists;
 	std::vector<Watchlist> p_watchlists;
+	std::vector<Watchlist> p_binlists;
+	// number of traversals of each watch list since the last compaction
+	std::vector<uint32_t> p_watchVisits;
+
+	util::memory::SlabAllocator p_occurPool;
+	// stores both the watch lists and the binary implication lists
+	util::memory::SlabAllocator p_watchPool;
+
 	std::vector<Literal> p_equivPointer;
 	
 	Index p_presentCount;
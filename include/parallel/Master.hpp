@@ -1,31 +1,67 @@
 
 class Master {
 public:
-	Master(const std::string &instance) : p_instance(instance) {
+	Master(const std::string &instance) : p_instance(instance),
+			p_parsedClauses(nullptr), p_solversStarted(false), p_exitCode(0) {
 	}
 	
+	struct OptsMaster {
+		// number of threads used to parse the instance
+		int parseThreads;
+		// drop clauses that are identical to an earlier clause while parsing
+		bool detectDuplicates;
+		/* parse the original clauses once into a ParsedClauses structure
+		 * instead of sending them to each thread individually. every thread
+		 * still copies them into its own clause arena */
+		bool parseOnce;
+		// start solving while the instance is still being parsed
+		bool onlineInput;
+		// soft memory limit in bytes that is split among all threads; 0 for no limit
+		uint64_t memLimit;
+
+		OptsMaster() : parseThreads(1), detectDuplicates(true), parseOnce(false),
+				onlineInput(false), memLimit(0) { }
+	} opts;
+	
 	int run();
 
-	std::vector<int>::iterator beginModel();
-	std::vector<int>::iterator endModel();
+	const satuzk::PackedModel &getModel();
 	
 private:
+	// thrown by the read hooks to stop parsing once the instance is solved
+	class InputAborted { };
+
 	class CnfReadHooks {
 	public:
-		CnfReadHooks(Master &master) : p_master(master) { }
+		CnfReadHooks(Master &master) : p_master(master), p_clauseCount(0) { }
 		
 		void onProblem(long num_vars, long num_clauses);
-		void onClause(std::vector<long> &in_clause);
+		uint64_t onClause(std::vector<long> &in_clause);
+		void onDroppedClause() { }
+
+		// reads clauses from the parsed clauses for the duplicate check
+		size_t storedLength(uint64_t handle);
+		long storedLiteral(uint64_t handle, size_t index);
 
 	private:
+		// number of clauses between two checks for solver messages
+		static const uint64_t kPollInterval = 1024;
+
 		long p_varCount;
 		Master &p_master;
+		uint64_t p_clauseCount;
 	};
+
+	void startSolvers();
+	bool checkSolvers();
 	
 	std::string p_instance;
-	std::vector<int> p_model;
+	satuzk::PackedModel p_model;
 	std::vector<std::thread> p_threads;
 	std::vector<SolverThread*> p_solvers;
 	std::vector<ReducerThread*> p_reducers;
+	ParsedClauses *p_parsedClauses;
+	bool p_solversStarted;
+	int p_exitCode;
 };
 
@@ -0,0 +1,29 @@
+
+#include <atomic>
+
+/* original clauses of the instance. they are parsed once by the master and
+ * then loaded by all solver and reducer threads without being serialized
+ * into their command pipes. the literals form a shared read-only arena:
+ * the threads refer to long clauses instead of copying them and keep their
+ * watches, flags and lbds in their own clause arenas. the literals are
+ * released after all threads exited */
+struct ParsedClauses {
+	ParsedClauses() : pendingThreads(0) {
+		offsets.push_back(0);
+	}
+	ParsedClauses(const ParsedClauses &other) = delete;
+	ParsedClauses &operator= (const ParsedClauses &other) = delete;
+
+	uint64_t numClauses() {
+		return offsets.size() - 1;
+	}
+
+	// clause i consists of literals[offsets[i]] ... literals[offsets[i + 1] - 1].
+	// released once all threads loaded the clauses
+	std::vector<uint64_t> offsets;
+	std::vector<BaseDefs::LiteralIndex> literals;
+
+	// number of threads that did not load the clauses yet
+	std::atomic<int> pendingThreads;
+};
+
@@ -18,7 +18,7 @@ class ReducerThread {
 friend class ReducerHooks;
 public:
 	enum class CommandTag {
-		kNone, kExit, kProblemDef, kClause, kInitialize
+		kNone, kExit, kProblemDef, kClause, kParsedClauses, kInitialize
 	};
 	
 	ReducerThread(int config_id) :
@@ -30,6 +30,9 @@ public:
 	ReducerThread(const ReducerThread &other) = delete;
 	ReducerThread &operator= (const ReducerThread &other) = delete;
 
+	// must be called before the thread is started
+	void limitMemory(uint64_t bytes) { p_config.opts.general.memLimit = bytes; }
+
 	void linkSolver(SolverThread &solver) {
 		p_solverLinks.emplace_back(solver);
 	}
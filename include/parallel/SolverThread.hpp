@@ -16,7 +16,8 @@ class SolverThread {
 friend class SolverHooks;
 public:
 	enum class CommandTag {
-		kNone, kExit, kProblemDef, kClause, kInitialize, kContinue, kAssume, kUnassume
+		kNone, kExit, kProblemDef, kClause, kParsedClauses, kInputDone,
+		kInitialize, kContinue, kAssume, kUnassume
 	};
 
 	enum class MessageTag {
@@ -28,16 +29,20 @@ public:
 			p_messageProducer(p_messagePipe), p_messageConsumer(p_messagePipe),
 			p_learnedProducer(p_learnedPipe),
 			p_config(SolverHooks(*this), config_id),
-			p_solveActive(false), p_threadExitFlag(false) {
+			p_solveActive(false), p_searchStarted(false), p_inputComplete(false),
+			p_restartPending(false), p_threadExitFlag(false) {
 		p_config.seedRandomEngine(config_id);
 	}
 	SolverThread(const SolverThread &other) = delete;
 	SolverThread &operator= (const SolverThread &other) = delete;
 
 	int getConfigId() { return p_config.getConfigId(); }
+	// must be called before the thread is started
+	void limitMemory(uint64_t bytes) { p_config.opts.general.memLimit = bytes; }
 
 	void checkReduced();
 	void checkCommand();
+	void finishInput();
 	void doWork();
 	void run();
 
@@ -93,6 +98,11 @@ private:
 	SolverConfig p_config;
 	sys::HptCounter p_lastMessage;
 	bool p_solveActive;
+	bool p_searchStarted;
+	// true if all clauses of the instance have been received
+	bool p_inputComplete;
+	// clauses were added after the search started; we have to call start()
+	bool p_restartPending;
 	bool p_idleRound;
 	bool p_threadExitFlag;
 	
@@ -100,8 +110,10 @@ public:
 	struct Stat {
 		uint64_t exported;
 		uint64_t imported;
+		// imported clauses that were dropped because of memory pressure
+		uint64_t dropped;
 		
-		Stat() : exported(0), imported(0) { }
+		Stat() : exported(0), imported(0), dropped(0) { }
 	} stat;
 };
 
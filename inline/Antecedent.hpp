@@ -19,6 +19,7 @@ template<typename BaseDefs>
 AntecedentStruct<BaseDefs> AntecedentStruct<BaseDefs>::makeClause(Clause clause) {
 	AntecedentStruct<BaseDefs> antecedent;
 	antecedent.type = kTypeClause;
+	antecedent.identifier.padding = 0;
 	antecedent.identifier.clause = clause.getIndex();
 	return antecedent;
 }
@@ -26,9 +27,20 @@ template<typename BaseDefs>
 AntecedentStruct<BaseDefs> AntecedentStruct<BaseDefs>::makeBinary(Literal literal) {
 	AntecedentStruct<BaseDefs> antecedent;
 	antecedent.type = kTypeBinary;
+	antecedent.identifier.padding = 0;
 	antecedent.identifier.literal = literal.getIndex();
 	return antecedent;
 }
+template<typename BaseDefs>
+AntecedentStruct<BaseDefs> AntecedentStruct<BaseDefs>::makeTernary(Literal literal1,
+		Literal literal2) {
+	AntecedentStruct<BaseDefs> antecedent;
+	SYS_ASSERT(SYS_ASRT_GENERAL, !(literal1.getIndex() & kTypeTernary));
+	antecedent.type = kTypeTernary | literal1.getIndex();
+	antecedent.identifier.padding = 0;
+	antecedent.identifier.literal = literal2.getIndex();
+	return antecedent;
+}
 
 template<typename BaseDefs>
 bool AntecedentStruct<BaseDefs>::operator== (AntecedentStruct<BaseDefs> other) {
@@ -55,6 +67,10 @@ template<typename BaseDefs>
 bool AntecedentStruct<BaseDefs>::isBinary() {
 	return type == kTypeBinary;
 }
+template<typename BaseDefs>
+bool AntecedentStruct<BaseDefs>::isTernary() {
+	return type & kTypeTernary;
+}
 
 template<typename BaseDefs>
 typename AntecedentStruct<BaseDefs>::Clause AntecedentStruct<BaseDefs>::getClause() {
@@ -64,6 +80,14 @@ template<typename BaseDefs>
 typename AntecedentStruct<BaseDefs>::Literal AntecedentStruct<BaseDefs>::getBinary() {
 	return Literal::fromIndex(identifier.literal);
 }
+template<typename BaseDefs>
+typename AntecedentStruct<BaseDefs>::Literal AntecedentStruct<BaseDefs>::getLiteral1() {
+	return Literal::fromIndex(type & ~kTypeTernary);
+}
+template<typename BaseDefs>
+typename AntecedentStruct<BaseDefs>::Literal AntecedentStruct<BaseDefs>::getLiteral2() {
+	return Literal::fromIndex(identifier.literal);
+}
 
 }; // namespace satuzk
 
@@ -0,0 +1,130 @@
+
+namespace satuzk {
+
+/* binary cnf snapshots store the clauses of an instance after they have
+ * been mapped to internal literal indices. the file consists of:
+ * - the header
+ * - numClauses + 1 offsets (uint64_t) into the literal array
+ * - numLiterals literal indices (BaseDefs::LiteralIndex) */
+struct BinaryCnfHeader {
+	static const uint32_t kVersion = 1;
+
+	char magic[8];
+	uint32_t version;
+	// size of a single literal index in bytes
+	uint32_t literalSize;
+	uint64_t numVariables;
+	uint64_t numClauses;
+	uint64_t numLiterals;
+};
+
+static const char kBinaryCnfMagic[8] = { 's', 'a', 't', 'U', 'Z', 'K', 'c', 'n' };
+
+// writes all present clauses of the configuration to a snapshot file
+template<typename Config>
+void dumpBinaryCnf(Config &config, uint64_t num_vars, const std::string &file_name) {
+	typedef typename Config::Literal::Index LiteralIndex;
+
+	std::vector<uint64_t> offsets;
+	std::vector<LiteralIndex> literals;
+	offsets.push_back(0);
+	for(auto i = config.clausesBegin(); i != config.clausesEnd(); ++i) {
+		if(!config.clauseIsPresent(*i))
+			continue;
+		for(auto j = config.clauseBegin(*i); j != config.clauseEnd(*i); ++j)
+			literals.push_back((*j).getIndex());
+		offsets.push_back(literals.size());
+	}
+
+	BinaryCnfHeader header;
+	std::memcpy(header.magic, kBinaryCnfMagic, sizeof(kBinaryCnfMagic));
+	header.version = BinaryCnfHeader::kVersion;
+	header.literalSize = sizeof(LiteralIndex);
+	header.numVariables = num_vars;
+	header.numClauses = offsets.size() - 1;
+	header.numLiterals = literals.size();
+
+	std::ofstream stream(file_name, std::ofstream::out
+			| std::ofstream::trunc | std::ofstream::binary);
+	stream.write((const char*)&header, sizeof(BinaryCnfHeader));
+	stream.write((const char*)offsets.data(), offsets.size() * sizeof(uint64_t));
+	stream.write((const char*)literals.data(), literals.size() * sizeof(LiteralIndex));
+	stream.close();
+	if(stream.fail())
+		throw std::runtime_error("Could not write binary cnf");
+}
+
+/* estimates the number of bytes that the clauses of a snapshot occupy in
+ * the clause space. returns 0 if the file does not start with a snapshot header */
+inline uint64_t estimateBinaryCnfSize(int fd) {
+	// head and alignment of a single clause
+	static const uint64_t kClauseOverhead = 16;
+
+	BinaryCnfHeader header;
+	ssize_t len = pread(fd, &header, sizeof(BinaryCnfHeader), 0);
+	if(len != sizeof(BinaryCnfHeader)
+			|| std::memcmp(header.magic, kBinaryCnfMagic, sizeof(kBinaryCnfMagic)) != 0)
+		return 0;
+	return header.numClauses * kClauseOverhead + header.numLiterals * header.literalSize;
+}
+
+// maps a snapshot file and inputs all of its clauses.
+// returns the number of variables of the instance
+template<typename Config>
+uint64_t loadBinaryCnf(Config &config, int fd) {
+	typedef typename Config::Literal::Index LiteralIndex;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0)
+		throw std::runtime_error("Could not stat input");
+	size_t length = st.st_size;
+	if(length < sizeof(BinaryCnfHeader))
+		throw std::runtime_error("Illegal binary cnf file");
+
+	void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(mapping == MAP_FAILED)
+		throw std::runtime_error("Could not map input");
+	madvise(mapping, length, MADV_SEQUENTIAL);
+
+	const BinaryCnfHeader *header = (const BinaryCnfHeader*)mapping;
+	if(std::memcmp(header->magic, kBinaryCnfMagic, sizeof(kBinaryCnfMagic)) != 0
+			|| header->version != BinaryCnfHeader::kVersion
+			|| header->literalSize != sizeof(LiteralIndex)
+			|| length != sizeof(BinaryCnfHeader)
+				+ (header->numClauses + 1) * sizeof(uint64_t)
+				+ header->numLiterals * sizeof(LiteralIndex)) {
+		munmap(mapping, length);
+		throw std::runtime_error("Illegal binary cnf file");
+	}
+
+	const uint64_t *offsets = (const uint64_t*)(header + 1);
+	const LiteralIndex *literals = (const LiteralIndex*)(offsets
+			+ header->numClauses + 1);
+
+	// check the clauses before we input them
+	bool valid = offsets[0] == 0 && offsets[header->numClauses] == header->numLiterals;
+	for(uint64_t i = 0; valid && i < header->numClauses; i++) {
+		if(offsets[i + 1] <= offsets[i])
+			valid = false;
+	}
+	for(uint64_t i = 0; valid && i < header->numLiterals; i++) {
+		if(literals[i] >= 2 * header->numVariables)
+			valid = false;
+	}
+	if(!valid) {
+		munmap(mapping, length);
+		throw std::runtime_error("Illegal binary cnf file");
+	}
+
+	config.varReserve(header->numVariables);
+	for(uint64_t i = 0; i < header->numVariables; ++i)
+		config.varAlloc();
+	config.inputBulk(header->numClauses, offsets, literals);
+
+	uint64_t num_vars = header->numVariables;
+	munmap(mapping, length);
+	return num_vars;
+}
+
+}; // namespace satuzk
+
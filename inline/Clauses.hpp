@@ -32,17 +32,29 @@ private:
 	Index p_index;
 };
 
-template<typename BaseDefs>
-class ClauseRef;
-
 template<typename BaseDefs>
 class ClauseIteratorStruct;
 
 template<typename BaseDefs>
 class ClauseSpaceStruct {
-friend class ClauseRef<BaseDefs>;
 public:
 	static const int kClauseAlign = 8;
+	// each arena must not exceed this size so that watch lists can
+	// use the most significant bit of the clause index as a flag
+	// and the least significant bit can select the arena
+	static const uint64_t kMaxBytes = sizeof(typename BaseDefs::ClauseIndex) >= sizeof(uint64_t)
+			? std::numeric_limits<uint64_t>::max() / 2
+			: ((uint64_t)1 << (sizeof(typename BaseDefs::ClauseIndex) * 8 - 2)) * kClauseAlign;
+
+	/* clauses are stored in two arenas. the old arena contains essential
+	 * and low-lbd clauses and is rarely compacted. fresh clauses are
+	 * allocated in the young arena and are promoted when they survive
+	 * a compaction of the young arena. */
+	static const int kArenaOld = 0;
+	static const int kArenaYoung = 1;
+	static const int kNumArenas = 2;
+	// the frozen clause store is not collected before it wastes this many bytes
+	static const uint64_t kFrozenMinWaste = 64 * 1024;
 	
 	typedef LiteralType<BaseDefs> Literal;
 	typedef typename BaseDefs::ClauseIndex Index;
@@ -52,34 +64,44 @@ public:
 	
 	struct ClauseHead {
 		// clause is installed i.e. in watch lists
-		static const uint32_t kFlagInstalled = 1;
+		static const uint16_t kFlagInstalled = 1;
 		// marked for deletion
-		static const uint32_t kFlagDelete = 2;
+		static const uint16_t kFlagDelete = 2;
 		// marked essential i.e. must not be deleted
-		static const uint32_t kFlagEssential = 4;
+		static const uint16_t kFlagEssential = 4;
 		// clause is frozen, i.e. not installed but will be reinstalled later
-		static const uint32_t kFlagFrozen = 8;
+		static const uint16_t kFlagFrozen = 8;
 		// the clause has been marked by some algorithm.
 		// algorithms should remove this mark after they are done.
-		static const uint32_t kFlagMarked = 16;
-		// clause has been moved/dropped during garbage collection
-		static const uint32_t kFlagCollectMoved = 32;
-		static const uint32_t kFlagCollectDropped = 64;
-		static const uint32_t kFlagImproved = 128;
-		static const uint32_t kFlagCheckedDist = 256;
-		static const uint32_t kFlagCreatedVecd = 512;
-		static const uint32_t kFlagCheckedSsub = 1024;
-
+		static const uint16_t kFlagMarked = 16;
+		// the literals are stored in the frozen clause store, see packClause()
+		static const uint16_t kFlagPacked = 32;
+		// the clause was moved to another index by unpackClause().
+		// set together with kFlagDelete; the metadata slot is still in use
+		static const uint16_t kFlagMoved = 64;
+		static const uint16_t kFlagImproved = 128;
+		static const uint16_t kFlagCheckedDist = 256;
+		static const uint16_t kFlagCreatedVecd = 512;
+		static const uint16_t kFlagCheckedSsub = 1024;
+		// the clause is watched by ternary watch list entries
+		static const uint16_t kFlagTernary = 2048;
+		// the literals are stored in the shared clause arena, see shareClause()
+		static const uint16_t kFlagShared = 4096;
+
+		// index of the clause's entry in the metadata table
+		Index slot;
 		// flags defined above
-		uint32_t flags;
+		uint16_t flags;
+		// literal-block-distance
+		uint16_t lbd;
 		// number of literals of the clause
 		LitIndex numLiterals;
 
 		/* we need a default constructor so that this structure
 			remains standard-layout */
 		ClauseHead() = default;
-		ClauseHead(LitIndex num_literals) : flags(0),
-				numLiterals(num_literals) { }
+		ClauseHead(Index slot, LitIndex num_literals) : slot(slot), flags(0),
+				lbd(0), numLiterals(num_literals) { }
 
 		// allows access to the clause body
 		void *access(int offset) {
@@ -92,141 +114,312 @@ public:
 		}
 	};
 
-	struct ClauseTail {
-		union {
-			struct {
-				Activity activity;
-				uint64_t signature;
-				uint16_t lbd;
-			} normalTail;
-			
-			struct {
-				Index destination;
-			} movedTail;
-		};
+	/* metadata that is not required during propagation.
+	 * it is stored outside of the arenas so that clauses stay compact */
+	struct ClauseInfo {
+		Activity activity;
+		uint64_t signature;
+		// stable id of the clause; used for lrat proofs
+		uint64_t id;
 	};
 	
 	static_assert(std::is_pod<ClauseHead>::value, "head not trivial");
-	static_assert(std::is_pod<ClauseTail>::value, "tail not trivial");
+	static_assert(std::is_pod<ClauseInfo>::value, "info not trivial");
+
+	/* stored in place of the literals of a shared clause. the literals in
+	 * the shared arena are never permuted; instead the record stores the
+	 * positions of the two watched literals. the remaining literals
+	 * follow in the order of the shared arena */
+	struct SharedRef {
+		// position of the first literal in the shared arena
+		uint64_t offset;
+		LitIndex watched[2];
+		// position at which the last search for a watched literal succeeded
+		LitIndex searchPos;
+	};
 
 	typedef typename std::vector<Index>::iterator IndexIterator;
 	typedef ClauseIteratorStruct<BaseDefs> ClauseIterator;
 
-	ClauseSpaceStruct() : p_allocator(kClauseAlign),
-			p_presentClauses(0), p_presentBytes(0), p_presentLiterals(0),
-			p_deletedClauses(0) { }
+	struct Arena {
+		Arena() : presentClauses(0), presentBytes(0), deletedClauses(0) { }
+
+		// indices of all clauses in this arena in ascending order
+		std::vector<Index> indices;
+		util::memory::BulkAllocator<Index, kClauseAlign> allocator;
+
+		unsigned int presentClauses;
+		uint64_t presentBytes;
+		unsigned int deletedClauses;
+	};
+
+	ClauseSpaceStruct() : p_frozenWaste(0), p_sharedLiterals(nullptr),
+			p_presentLiterals(0) { }
 	ClauseSpaceStruct(const ClauseSpaceStruct &other) = delete;
 	ClauseSpaceStruct &operator= (const ClauseSpaceStruct &other) = delete;
 
-	ClauseSpaceStruct &operator= (ClauseSpaceStruct &&other) {
-		p_allocator = std::move(other.p_allocator);
-		p_indices = std::move(other.p_indices);
-		p_presentBytes = other.p_presentBytes;
-		p_presentClauses = other.p_presentClauses;
-		p_deletedClauses = other.p_deletedClauses;
-		p_presentLiterals = other.p_presentLiterals;
-		return *this;
+	static int arenaOf(Clause clause) {
+		return clause.getIndex() & 1;
 	}
 
 //FIXME:private:
-	LitIndex p_padLength(LitIndex length) {
-		if(length % 2 == 1)
-			return length + 1;
-		return length;
-	}
 	ClauseHead *p_accessHead(Index index) {
-		return (ClauseHead*)p_allocator[index];
+		return (ClauseHead*)p_arenas[index & 1].allocator[index >> 1];
 	}
-	ClauseTail *p_accessTail(Index index) {
-		auto headptr = p_accessHead(index);
-		auto adj_length = p_padLength(headptr->numLiterals);
-		return (ClauseTail*)headptr->access(adj_length * sizeof(Literal));
+	ClauseInfo *p_accessInfo(Index index) {
+		return &p_infos[p_accessHead(index)->slot];
 	}
-
-public:
-	Index calcBytes(LitIndex length) {
-		return sizeof(ClauseHead)
-				+ p_padLength(length) * sizeof(Literal)
-				+ sizeof(ClauseTail);
+	LitIndex *p_searchPos(ClauseHead *head) {
+		return (LitIndex*)head->access(head->numLiterals * sizeof(Literal));
+	}
+	bool p_isShared(ClauseHead *head) {
+		return BaseDefs::kSharedClauses && (head->flags & ClauseHead::kFlagShared);
+	}
+	SharedRef p_sharedRef(ClauseHead *head) {
+		SharedRef ref;
+		std::memcpy(&ref, head->access(0), sizeof(SharedRef));
+		return ref;
+	}
+	void p_setSharedRef(ClauseHead *head, const SharedRef &ref) {
+		std::memcpy(head->access(0), &ref, sizeof(SharedRef));
+	}
+	// maps the index of a literal to its position in the shared arena
+	static LitIndex p_sharedPosition(const SharedRef &ref, LitIndex index) {
+		if(index < 2)
+			return ref.watched[index];
+		LitIndex low = std::min(ref.watched[0], ref.watched[1]);
+		LitIndex high = std::max(ref.watched[0], ref.watched[1]);
+		index -= 2;
+		if(index >= low)
+			index++;
+		if(index >= high)
+			index++;
+		return index;
 	}
 
-	Clause allocClause(LitIndex length) {
-		// allocate memory for the clause
-		Index bytelen = calcBytes(length);
-		Index index = p_allocator.alloc(bytelen);
-
-		// we have to setup the head before we can use p_accessTail()!
-		ClauseHead *head = p_accessHead(index);
-		new (head) ClauseHead(length);
-
-		auto tail = p_accessTail(index);
-		tail->normalTail.lbd = 0;
-		tail->normalTail.activity = 0.0f;
-		tail->normalTail.signature = 0;
-
-		p_indices.push_back(index);
-		p_presentBytes += bytelen;
-		p_presentClauses++;
-		p_presentLiterals += length;
-		return Clause::fromIndex(index);
+public:
+	/* long clauses store the position at which the last search for a new
+	 * watched literal succeeded after their literals. the next search
+	 * resumes there instead of rescanning the clause from the start */
+	static const LitIndex kSearchPosLength = 16;
+
+	static bool hasSearchPos(LitIndex length) {
+		return length >= kSearchPosLength;
+	}
+	uint64_t calcBytes(LitIndex length) {
+		uint64_t bytes = sizeof(ClauseHead) + length * sizeof(Literal);
+		if(hasSearchPos(length))
+			bytes += sizeof(LitIndex);
+		return bytes;
+	}
+	// number of bytes the clause occupies in its arena
+	uint64_t recordBytes(ClauseHead *head) {
+		if(head->flags & ClauseHead::kFlagPacked)
+			return sizeof(ClauseHead) + sizeof(uint64_t);
+		if(p_isShared(head))
+			return sizeof(ClauseHead) + sizeof(SharedRef);
+		return calcBytes(head->numLiterals);
+	}
+
+	Clause allocClause(LitIndex length, int arena) {
+		uint64_t bytelen = calcBytes(length);
+		Clause clause = p_allocRecord(length, bytelen, arena);
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(hasSearchPos(length))
+			*p_searchPos(head) = 2;
+		return clause;
+	}
+
+	/* clauses of the original instance can be shared by multiple solvers.
+	 * shareClause() allocates a clause whose literals are read from
+	 * the shared arena at the given offset. the arena is never written */
+	void setSharedLiterals(Literal *literals) {
+		p_sharedLiterals = literals;
+	}
+	Clause shareClause(LitIndex length, uint64_t offset, int arena) {
+		SYS_ASSERT(SYS_ASRT_GENERAL, worthSharing(length));
+		Clause clause = p_allocRecord(length, sizeof(ClauseHead) + sizeof(SharedRef), arena);
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		head->flags |= ClauseHead::kFlagShared;
+		SharedRef ref;
+		ref.offset = offset;
+		ref.watched[0] = 0;
+		ref.watched[1] = 1;
+		ref.searchPos = 2;
+		p_setSharedRef(head, ref);
+		return clause;
+	}
+	// sharing only pays off if the literals take more space than the reference
+	static bool worthSharing(LitIndex length) {
+		return BaseDefs::kSharedClauses && length * sizeof(Literal) > sizeof(SharedRef);
+	}
+	bool isShared(Clause clause) {
+		return p_isShared(p_accessHead(clause.getIndex()));
+	}
+	// literals of a shared clause in the order of the shared arena
+	Literal *sharedLiterals(Clause clause) {
+		return p_sharedLiterals + p_sharedRef(p_accessHead(clause.getIndex())).offset;
+	}
+	// position of a watched literal of a shared clause in the shared arena
+	LitIndex sharedWatched(Clause clause, int which) {
+		return p_sharedRef(p_accessHead(clause.getIndex())).watched[which];
+	}
+
+	// called once a deleted clause is removed from its arena
+	void releaseClause(Clause clause) {
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(!(head->flags & ClauseHead::kFlagMoved))
+			p_freeSlots.push_back(head->slot);
+	}
+
+	/* frozen clauses do not need fast access to their literals.
+	 * packClause() moves the literals of a clause to the frozen clause store
+	 * where they are sorted and delta encoded as a sequence of 7-bit groups.
+	 * only the head and the offset into the store remain in the arena;
+	 * the arena shrinks during its next compaction. */
+	void packClause(Clause clause);
+	// packing only pays off if the literals take more space than the offset
+	static bool worthPacking(LitIndex length) {
+		return length * sizeof(Literal) > sizeof(uint64_t);
+	}
+	/* moves a packed clause back into the given arena. returns the new
+	 * clause; the old index must not be used anymore */
+	Clause unpackClause(Clause clause, int arena);
+	// decodes the literals of a packed clause
+	void unpackLiterals(Clause clause, std::vector<Literal> &literals);
+	bool isPacked(Clause clause) {
+		return p_accessHead(clause.getIndex())->flags & ClauseHead::kFlagPacked;
+	}
+	uint64_t frozenStoreBytes() {
+		return p_frozenStore.size();
 	}
 
 	ClauseIterator begin();
 	ClauseIterator end();
 
 	unsigned int numClauses() {
-		return p_indices.size();
+		return p_arenas[kArenaOld].indices.size()
+				+ p_arenas[kArenaYoung].indices.size();
 	}
 	unsigned int numPresent() {
-		return p_presentClauses;
+		return p_arenas[kArenaOld].presentClauses
+				+ p_arenas[kArenaYoung].presentClauses;
 	}
 	uint64_t presentBytes() {
-		return p_presentBytes;
+		return p_arenas[kArenaOld].presentBytes
+				+ p_arenas[kArenaYoung].presentBytes;
 	}
 	uint64_t presentLiterals() {
 		return p_presentLiterals;
 	}
 	unsigned int numDeleted() {
-		return p_deletedClauses;
+		return p_arenas[kArenaOld].deletedClauses
+				+ p_arenas[kArenaYoung].deletedClauses;
 	}
 	
 	LitIndex clauseLength(Clause clause) {
 		return p_accessHead(clause.getIndex())->numLiterals;
 	}
 	void clauseSetLiteral(Clause clause, LitIndex index, Literal literal) {
+		SYS_ASSERT(SYS_ASRT_GENERAL, !isShared(clause));
 		*p_accessHead(clause.getIndex())->literal(index) = literal;
 	}
 	Literal clauseGetLiteral(Clause clause, LitIndex index) {
-		return *p_accessHead(clause.getIndex())->literal(index);
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(p_isShared(head)) {
+			SharedRef ref = p_sharedRef(head);
+			return p_sharedLiterals[ref.offset + p_sharedPosition(ref, index)];
+		}
+		return *head->literal(index);
+	}
+	// allows direct access to the literals of a clause that is not shared
+	Literal *clauseLiterals(Clause clause) {
+		SYS_ASSERT(SYS_ASRT_GENERAL, !isShared(clause));
+		return p_accessHead(clause.getIndex())->literal(0);
+	}
+	// exchanges the first and the second literal
+	void clauseSwapWatched(Clause clause) {
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(p_isShared(head)) {
+			SharedRef ref = p_sharedRef(head);
+			std::swap(ref.watched[0], ref.watched[1]);
+			p_setSharedRef(head, ref);
+			return;
+		}
+		std::swap(*head->literal(0), *head->literal(1));
+	}
+	/* exchanges the second literal with the literal at the given address.
+	 * for shared clauses the address must point into sharedLiterals() */
+	void clauseWatchSecond(Clause clause, Literal *replacement) {
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(p_isShared(head)) {
+			SharedRef ref = p_sharedRef(head);
+			ref.watched[1] = replacement - (p_sharedLiterals + ref.offset);
+			p_setSharedRef(head, ref);
+			return;
+		}
+		std::swap(*head->literal(1), *replacement);
+	}
+	/* only valid if hasSearchPos() is true for the clause length or if the
+	 * clause is shared. shared clauses store a position in the shared arena */
+	LitIndex clauseGetSearchPos(Clause clause) {
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(p_isShared(head))
+			return p_sharedRef(head).searchPos;
+		return *p_searchPos(head);
+	}
+	void clauseSetSearchPos(Clause clause, LitIndex position) {
+		ClauseHead *head = p_accessHead(clause.getIndex());
+		if(p_isShared(head)) {
+			SharedRef ref = p_sharedRef(head);
+			ref.searchPos = position;
+			p_setSharedRef(head, ref);
+			return;
+		}
+		*p_searchPos(head) = position;
+	}
+	// loads the header and the first literals of a clause into the cache
+	void clausePrefetch(Clause clause) {
+		__builtin_prefetch(p_accessHead(clause.getIndex()));
 	}
 
 	void clauseSetActivity(Clause clause, Activity activity) {
-		p_accessTail(clause.getIndex())->normalTail.activity = activity;
+		p_accessInfo(clause.getIndex())->activity = activity;
 	}
 	Activity clauseGetActivity(Clause clause) {
-		return p_accessTail(clause.getIndex())->normalTail.activity;
+		return p_accessInfo(clause.getIndex())->activity;
 	}
 
 	void clauseSetSignature(Clause clause, uint64_t signature) {
-		p_accessTail(clause.getIndex())->normalTail.signature = signature;
+		p_accessInfo(clause.getIndex())->signature = signature;
 	}
 	uint64_t clauseGetSignature(Clause clause) {
-		return p_accessTail(clause.getIndex())->normalTail.signature;
+		return p_accessInfo(clause.getIndex())->signature;
+	}
+
+	void clauseSetId(Clause clause, uint64_t id) {
+		p_accessInfo(clause.getIndex())->id = id;
+	}
+	uint64_t clauseGetId(Clause clause) {
+		return p_accessInfo(clause.getIndex())->id;
 	}
 
 	void clauseSetLbd(Clause clause, uint16_t lbd) {
-		p_accessTail(clause.getIndex())->normalTail.lbd = lbd;
+		p_accessHead(clause.getIndex())->lbd = lbd;
 	}
 	uint16_t clauseGetLbd(Clause clause) {
-		return p_accessTail(clause.getIndex())->normalTail.lbd;
+		return p_accessHead(clause.getIndex())->lbd;
 	}
 
 	void deleteClause(Clause clause) {
+		Arena &arena = p_arenas[arenaOf(clause)];
 		p_accessHead(clause.getIndex())->flags |= ClauseHead::kFlagDelete;
-		p_presentClauses--;
-		p_deletedClauses++;
-		p_presentBytes -= calcBytes(p_accessHead(clause.getIndex())->numLiterals);
-		p_presentLiterals += p_accessHead(clause.getIndex())->numLiterals;
+		arena.presentClauses--;
+		arena.deletedClauses++;
+		arena.presentBytes -= recordBytes(p_accessHead(clause.getIndex()));
+		p_presentLiterals -= p_accessHead(clause.getIndex())->numLiterals;
+		if(p_accessHead(clause.getIndex())->flags & ClauseHead::kFlagPacked)
+			p_frozenWaste += p_frozenRecordBytes(p_accessHead(clause.getIndex()));
 	}
 	bool isDeleted(Clause clause) {
 		return p_accessHead(clause.getIndex())->flags & ClauseHead::kFlagDelete;
@@ -260,102 +453,399 @@ public:
 	void setFlagCheckedSsub(Clause clause) { p_accessHead(clause.getIndex())->flags |= ClauseHead::kFlagCheckedSsub; }
 	bool getFlagCheckedSsub(Clause clause) { return p_accessHead(clause.getIndex())->flags & ClauseHead::kFlagCheckedSsub; }
 
-	std::vector<Index> p_indices;
-	util::memory::BulkAllocator<typename BaseDefs::ClauseIndex> p_allocator;
+	void setFlagTernary(Clause clause) { p_accessHead(clause.getIndex())->flags |= ClauseHead::kFlagTernary; }
+	bool getFlagTernary(Clause clause) { return p_accessHead(clause.getIndex())->flags & ClauseHead::kFlagTernary; }
+	void unsetFlagTernary(Clause clause) { p_accessHead(clause.getIndex())->flags &= ~ClauseHead::kFlagTernary; }
+
+	uint64_t p_frozenOffset(ClauseHead *head) {
+		uint64_t offset;
+		std::memcpy(&offset, head->access(0), sizeof(uint64_t));
+		return offset;
+	}
+	uint64_t p_frozenRecordBytes(ClauseHead *head);
+	void p_collectFrozenStore();
+
+	Clause p_allocRecord(LitIndex length, uint64_t bytelen, int arena) {
+		// reuse the metadata slot of a collected clause if possible
+		Index slot;
+		if(!p_freeSlots.empty()) {
+			slot = p_freeSlots.back();
+			p_freeSlots.pop_back();
+		}else{
+			slot = p_infos.size();
+			p_infos.push_back(ClauseInfo());
+		}
+		ClauseInfo *info = &p_infos[slot];
+		info->activity = 0.0f;
+		info->signature = 0;
+		info->id = 0;
+
+		// allocate memory for the clause
+		Index index = (p_arenas[arena].allocator.alloc(bytelen) << 1) | arena;
+		ClauseHead *head = p_accessHead(index);
+		new (head) ClauseHead(slot, length);
+
+		p_arenas[arena].indices.push_back(index);
+		p_arenas[arena].presentBytes += bytelen;
+		p_arenas[arena].presentClauses++;
+		p_presentLiterals += length;
+		return Clause::fromIndex(index);
+	}
+
+	Arena p_arenas[kNumArenas];
+	std::vector<ClauseInfo> p_infos;
+	std::vector<Index> p_freeSlots;
+
+	// encoded literals of packed clauses
+	std::vector<uint8_t> p_frozenStore;
+	// bytes of the store that belong to deleted or unpacked clauses
+	uint64_t p_frozenWaste;
+
+	// literals of shared clauses; owned by the caller of setSharedLiterals()
+	Literal *p_sharedLiterals;
 
-	unsigned int p_presentClauses;
-	uint64_t p_presentBytes;
 	uint64_t p_presentLiterals;
-	unsigned int p_deletedClauses;
 };
 
+// maps the indices of clauses before a compaction to their new indices
 template<typename BaseDefs>
-class ClauseRef {
-private:
-	ClauseRef(ClauseSpaceStruct<BaseDefs> &config, typename BaseDefs::ClauseIndex clause_id)
-			: p_config(config), p_clauseId(clause_id) {
-	}
-	
-	bool wasMoved();
-	bool wasDropped();
-	typename BaseDefs::ClauseIndex getMoveDestination();
-	
+class ClauseForwardingStruct {
 public:
-	ClauseSpaceStruct<BaseDefs> &p_config;
-	typename BaseDefs::ClauseIndex p_clauseId;
+	typedef typename BaseDefs::ClauseIndex Index;
+
+	ClauseType<BaseDefs> lookup(ClauseType<BaseDefs> clause) {
+		// clauses in other arenas are not moved
+		if(ClauseSpaceStruct<BaseDefs>::arenaOf(clause) != p_arena)
+			return clause;
+		// the old indices are sorted as clauses are allocated in ascending order
+		auto it = std::lower_bound(p_sources.begin(), p_sources.end(), clause.getIndex());
+		SYS_ASSERT(SYS_ASRT_GENERAL, it != p_sources.end() && *it == clause.getIndex());
+		return ClauseType<BaseDefs>::fromIndex(p_destinations[it - p_sources.begin()]);
+	}
+
+	int p_arena;
+	std::vector<Index> p_sources;
+	std::vector<Index> p_destinations;
 };
 
+/* removes deleted clauses from an arena by sliding all present clauses
+ * towards the beginning of the arena. when the young arena is compacted
+ * clauses selected by callback.onPromote() are moved to the old arena.
+ * the callback is notified about the new positions before the clauses
+ * are moved and can update its references */
+template<typename BaseDefs, typename Callback>
+void compactClauses(ClauseSpaceStruct<BaseDefs> &config, int arena, Callback &callback) {
+	typedef ClauseSpaceStruct<BaseDefs> Space;
+	typename Space::Arena &source = config.p_arenas[arena];
+	typename Space::Arena &old = config.p_arenas[Space::kArenaOld];
+
+	// determine which clauses are promoted to the old arena
+	std::vector<bool> promote(source.indices.size(), false);
+	uint64_t promote_bytes = 0;
+	if(arena == Space::kArenaYoung) {
+		for(size_t i = 0; i < source.indices.size(); i++) {
+			typename Space::ClauseHead *head = config.p_accessHead(source.indices[i]);
+			if(head->flags & Space::ClauseHead::kFlagDelete)
+				continue;
+			if(!callback.onPromote(ClauseType<BaseDefs>::fromIndex(source.indices[i])))
+				continue;
+			promote[i] = true;
+			promote_bytes += config.recordBytes(head);
+		}
+		callback.onReserve(Space::kArenaOld, promote_bytes);
+	}
+
+	// compute the new position of each clause
+	ClauseForwardingStruct<BaseDefs> forwarding;
+	forwarding.p_arena = arena;
+	forwarding.p_sources.reserve(source.presentClauses);
+	forwarding.p_destinations.reserve(source.presentClauses);
+	source.allocator.rewind();
+	for(size_t i = 0; i < source.indices.size(); i++) {
+		typename Space::Index index = source.indices[i];
+		typename Space::ClauseHead *head = config.p_accessHead(index);
+		if(head->flags & Space::ClauseHead::kFlagDelete) {
+			callback.onErase(ClauseType<BaseDefs>::fromIndex(index));
+			config.releaseClause(ClauseType<BaseDefs>::fromIndex(index));
+			continue;
+		}
+		uint64_t bytes = config.recordBytes(head);
+		typename Space::Index destination;
+		if(promote[i]) {
+			destination = (old.allocator.alloc(bytes) << 1) | Space::kArenaOld;
+			old.indices.push_back(destination);
+			old.presentClauses++;
+			old.presentBytes += bytes;
+			source.presentClauses--;
+			source.presentBytes -= bytes;
+		}else{
+			// clauses only move towards the beginning of their arena
+			destination = (source.allocator.alloc(bytes) << 1) | arena;
+			SYS_ASSERT(SYS_ASRT_GENERAL, destination <= index);
+		}
+		forwarding.p_sources.push_back(index);
+		forwarding.p_destinations.push_back(destination);
+	}
+	callback.onForward(forwarding);
+
+	// move the clauses in ascending order so that no clause is overwritten
+	std::vector<typename Space::Index> indices;
+	indices.reserve(source.presentClauses);
+	for(size_t i = 0; i < forwarding.p_sources.size(); i++) {
+		typename Space::Index from = forwarding.p_sources[i];
+		typename Space::Index to = forwarding.p_destinations[i];
+		if(from != to)
+			std::memmove(config.p_accessHead(to), config.p_accessHead(from),
+					config.recordBytes(config.p_accessHead(from)));
+		if(Space::arenaOf(Space::Clause::fromIndex(to)) == arena)
+			indices.push_back(to);
+	}
+	source.indices.swap(indices);
+	source.deletedClauses = 0;
+}
+
+// orders (source, destination) pairs by their source
+template<typename Index>
+struct ForwardingPairLt {
+	bool operator() (const std::pair<Index, Index> &a, const std::pair<Index, Index> &b) {
+		return a.first < b.first;
+	}
+};
+
+/* copies the clauses of an arena to the given block of memory which
+ * replaces the memory of the arena. the clauses in order are laid out first
+ * (clauses of other arenas and duplicates are skipped), all remaining
+ * clauses follow in their current order. the arena must not contain
+ * deleted clauses. the caller releases the old memory afterwards */
+template<typename BaseDefs, typename Callback>
+void reorderClauses(ClauseSpaceStruct<BaseDefs> &config, int arena,
+		std::vector<ClauseType<BaseDefs>> &order,
+		void *memory, uint64_t length, Callback &callback) {
+	typedef ClauseSpaceStruct<BaseDefs> Space;
+	typedef typename Space::Index Index;
+	typename Space::Arena &source = config.p_arenas[arena];
+	SYS_ASSERT(SYS_ASRT_GENERAL, source.deletedClauses == 0);
+
+	util::memory::BulkAllocator<Index, Space::kClauseAlign> target;
+	target.initMemory(memory, length);
+
+	// the indices of the arena are sorted; emitted clauses are tracked by position
+	std::vector<bool> emitted(source.indices.size(), false);
+	std::vector<std::pair<Index, Index>> moves;
+	moves.reserve(source.indices.size());
+	for(auto it = order.begin(); it != order.end(); ++it) {
+		if(Space::arenaOf(*it) != arena)
+			continue;
+		auto position = std::lower_bound(source.indices.begin(),
+				source.indices.end(), (*it).getIndex());
+		SYS_ASSERT(SYS_ASRT_GENERAL, position != source.indices.end()
+				&& *position == (*it).getIndex());
+		if(emitted[position - source.indices.begin()])
+			continue;
+		emitted[position - source.indices.begin()] = true;
+
+		uint64_t bytes = config.recordBytes(config.p_accessHead((*it).getIndex()));
+		moves.push_back(std::make_pair((*it).getIndex(),
+				(Index)((target.alloc(bytes) << 1) | arena)));
+	}
+	for(size_t i = 0; i < source.indices.size(); i++) {
+		if(emitted[i])
+			continue;
+		uint64_t bytes = config.recordBytes(config.p_accessHead(source.indices[i]));
+		moves.push_back(std::make_pair(source.indices[i],
+				(Index)((target.alloc(bytes) << 1) | arena)));
+	}
+
+	// the destinations are ascending in emission order
+	std::vector<Index> indices;
+	indices.reserve(moves.size());
+	for(auto it = moves.begin(); it != moves.end(); ++it) {
+		std::memcpy(target[(*it).second >> 1], config.p_accessHead((*it).first),
+				config.recordBytes(config.p_accessHead((*it).first)));
+		indices.push_back((*it).second);
+	}
+
+	// lookups require the forwarding table to be sorted by source
+	ForwardingPairLt<Index> comparator;
+	std::sort(moves.begin(), moves.end(), comparator);
+	ClauseForwardingStruct<BaseDefs> forwarding;
+	forwarding.p_arena = arena;
+	forwarding.p_sources.reserve(moves.size());
+	forwarding.p_destinations.reserve(moves.size());
+	for(auto it = moves.begin(); it != moves.end(); ++it) {
+		forwarding.p_sources.push_back((*it).first);
+		forwarding.p_destinations.push_back((*it).second);
+	}
+	callback.onForward(forwarding);
+
+	source.allocator = std::move(target);
+	source.indices.swap(indices);
+}
+
 template<typename BaseDefs>
-bool ClauseRef<BaseDefs>::wasMoved() {
-	return p_config.p_accessHead(p_clauseId)->flags & ClauseSpaceStruct<BaseDefs>::ClauseHead::kFlagCollectMoved;
+void ClauseSpaceStruct<BaseDefs>::packClause(Clause clause) {
+	ClauseHead *head = p_accessHead(clause.getIndex());
+	SYS_ASSERT(SYS_ASRT_GENERAL, !(head->flags & ClauseHead::kFlagPacked));
+	// the offset is stored in place of the first literals
+	SYS_ASSERT(SYS_ASRT_GENERAL, worthPacking(head->numLiterals));
+
+	std::vector<Index> indices;
+	indices.reserve(head->numLiterals);
+	for(LitIndex i = 0; i < head->numLiterals; i++)
+		indices.push_back(head->literal(i)->getIndex());
+	std::sort(indices.begin(), indices.end());
+
+	// the first literal is stored as it is, the others as distance to their predecessor
+	uint64_t offset = p_frozenStore.size();
+	Index previous = 0;
+	for(auto it = indices.begin(); it != indices.end(); ++it) {
+		uint64_t value = *it - previous;
+		while(value > 127) {
+			p_frozenStore.push_back(128 | (value & 127));
+			value >>= 7;
+		}
+		p_frozenStore.push_back(value);
+		previous = *it;
+	}
+
+	Arena &arena = p_arenas[arenaOf(clause)];
+	arena.presentBytes -= recordBytes(head);
+	head->flags |= ClauseHead::kFlagPacked;
+	arena.presentBytes += recordBytes(head);
+	std::memcpy(head->access(0), &offset, sizeof(uint64_t));
 }
+
 template<typename BaseDefs>
-bool ClauseRef<BaseDefs>::wasDropped() {
-	return p_config.p_accessHead(p_clauseId)->flags & ClauseSpaceStruct<BaseDefs>::ClauseHead::kFlagCollectDropped;
+void ClauseSpaceStruct<BaseDefs>::unpackLiterals(Clause clause,
+		std::vector<Literal> &literals) {
+	ClauseHead *head = p_accessHead(clause.getIndex());
+	SYS_ASSERT(SYS_ASRT_GENERAL, head->flags & ClauseHead::kFlagPacked);
+
+	literals.clear();
+	uint8_t *pointer = p_frozenStore.data() + p_frozenOffset(head);
+	Index previous = 0;
+	for(LitIndex i = 0; i < head->numLiterals; i++) {
+		uint64_t value = 0;
+		int shift = 0;
+		while(*pointer & 128) {
+			value |= (uint64_t)(*pointer & 127) << shift;
+			shift += 7;
+			pointer++;
+		}
+		value |= (uint64_t)*pointer << shift;
+		pointer++;
+
+		previous += value;
+		literals.push_back(Literal::fromIndex(previous));
+	}
 }
+
 template<typename BaseDefs>
-typename BaseDefs::ClauseIndex ClauseRef<BaseDefs>::getMoveDestination() {
-	assert(wasMoved());
-	return p_config.p_accessTail(p_clauseId)->movedTail.destination;
+typename ClauseSpaceStruct<BaseDefs>::Clause ClauseSpaceStruct<BaseDefs>::unpackClause(
+		Clause clause, int arena) {
+	std::vector<Literal> literals;
+	unpackLiterals(clause, literals);
+
+	// the new record inherits the metadata slot
+	ClauseHead *old_head = p_accessHead(clause.getIndex());
+	ClauseHead head = *old_head;
+	uint64_t old_bytes = recordBytes(old_head);
+	p_frozenWaste += p_frozenRecordBytes(old_head);
+	old_head->flags = ClauseHead::kFlagDelete | ClauseHead::kFlagMoved;
+	Arena &old_arena = p_arenas[arenaOf(clause)];
+	old_arena.presentClauses--;
+	old_arena.presentBytes -= old_bytes;
+	old_arena.deletedClauses++;
+
+	uint64_t bytes = calcBytes(head.numLiterals);
+	Index index = (p_arenas[arena].allocator.alloc(bytes) << 1) | arena;
+	ClauseHead *new_head = p_accessHead(index);
+	*new_head = head;
+	new_head->flags &= ~ClauseHead::kFlagPacked;
+	for(LitIndex i = 0; i < head.numLiterals; i++)
+		*new_head->literal(i) = literals[i];
+	if(hasSearchPos(head.numLiterals))
+		*p_searchPos(new_head) = 2;
+	p_arenas[arena].indices.push_back(index);
+	p_arenas[arena].presentBytes += bytes;
+	p_arenas[arena].presentClauses++;
+
+	if(p_frozenWaste > kFrozenMinWaste && p_frozenWaste > p_frozenStore.size() / 2)
+		p_collectFrozenStore();
+	return Clause::fromIndex(index);
 }
 
-template<typename BaseDefs, typename Callback>
-void relocateClauses(ClauseSpaceStruct<BaseDefs> &from_config, ClauseSpaceStruct<BaseDefs> &to_config, Callback &callback) {
-	for(typename ClauseSpaceStruct<BaseDefs>::IndexIterator it = from_config.p_indices.begin();
-			it != from_config.p_indices.end(); ++it) {
-		typename ClauseSpaceStruct<BaseDefs>::Index from_index = *it;
-		typename ClauseSpaceStruct<BaseDefs>::ClauseHead *from_head = from_config.p_accessHead(from_index);
-		if(from_head->flags & ClauseSpaceStruct<BaseDefs>::ClauseHead::kFlagDelete) {
-			callback.onErase(ClauseType<BaseDefs>::fromIndex(from_index));
-			from_head->flags |= ClauseSpaceStruct<BaseDefs>::ClauseHead::kFlagCollectDropped;
-		}else{
-			// allocate the new clause
-			typename ClauseSpaceStruct<BaseDefs>::Clause to_clause = to_config.allocClause(from_head->numLiterals);
-			typename ClauseSpaceStruct<BaseDefs>::Index to_index = to_clause.getIndex();
-			auto from_tail = from_config.p_accessTail(from_index);
-			typename ClauseSpaceStruct<BaseDefs>::ClauseHead *to_head = to_config.p_accessHead(to_index);
-			auto to_tail = to_config.p_accessTail(to_index);
-			
-			// copy all flags, literals, etc.
-			for(typename ClauseSpaceStruct<BaseDefs>::LitIndex i = 0; i < from_head->numLiterals; i++) {
-				typename ClauseSpaceStruct<BaseDefs>::Literal literal = *from_head->literal(i);
-				*to_head->literal(i) = literal;
-			}
-			to_head->flags = from_head->flags;
-			to_tail->normalTail.lbd = from_tail->normalTail.lbd;
-			to_tail->normalTail.activity = from_tail->normalTail.activity;
-			to_tail->normalTail.signature = from_tail->normalTail.signature;
-
-			callback.onMove(ClauseType<BaseDefs>::fromIndex(from_index), to_clause);
-			from_head->flags |= ClauseSpaceStruct<BaseDefs>::ClauseHead::kFlagCollectMoved;
-			from_tail->movedTail.destination = to_index;
+template<typename BaseDefs>
+uint64_t ClauseSpaceStruct<BaseDefs>::p_frozenRecordBytes(ClauseHead *head) {
+	uint64_t offset = p_frozenOffset(head);
+	uint64_t end = offset;
+	for(LitIndex i = 0; i < head->numLiterals; i++) {
+		while(p_frozenStore[end] & 128)
+			end++;
+		end++;
+	}
+	return end - offset;
+}
+
+// removes the records of deleted and unpacked clauses from the frozen clause store
+template<typename BaseDefs>
+void ClauseSpaceStruct<BaseDefs>::p_collectFrozenStore() {
+	std::vector<uint8_t> store;
+	store.reserve(p_frozenStore.size() - p_frozenWaste);
+	for(int k = 0; k < kNumArenas; k++) {
+		for(auto it = p_arenas[k].indices.begin(); it != p_arenas[k].indices.end(); ++it) {
+			ClauseHead *head = p_accessHead(*it);
+			if((head->flags & ClauseHead::kFlagDelete)
+					|| !(head->flags & ClauseHead::kFlagPacked))
+				continue;
+			uint64_t offset = p_frozenOffset(head);
+			uint64_t length = p_frozenRecordBytes(head);
+			uint64_t new_offset = store.size();
+			store.insert(store.end(), p_frozenStore.begin() + offset,
+					p_frozenStore.begin() + offset + length);
+			std::memcpy(head->access(0), &new_offset, sizeof(uint64_t));
 		}
 	}
-	from_config.p_deletedClauses = 0;
+	p_frozenStore.swap(store);
+	p_frozenWaste = 0;
 }
 
 template<typename BaseDefs>
 class ClauseIteratorStruct
 	: public std::iterator<std::forward_iterator_tag, ClauseType<BaseDefs>> {
 public:
-	ClauseIteratorStruct(ClauseSpaceStruct<BaseDefs> &config,
+	ClauseIteratorStruct(ClauseSpaceStruct<BaseDefs> &config, int arena,
 			typename ClauseSpaceStruct<BaseDefs>::IndexIterator iterator)
-		: p_iterator(iterator) { }
+		: p_config(&config), p_arena(arena), p_iterator(iterator) {
+		p_skipArenas();
+	}
 
 	void operator++ () {
 		p_iterator++;
+		p_skipArenas();
 	}
 	bool operator== (const ClauseIteratorStruct<BaseDefs> &other) const {
-		return p_iterator == other.p_iterator;
+		return p_arena == other.p_arena && p_iterator == other.p_iterator;
 	}
 	bool operator!= (const ClauseIteratorStruct<BaseDefs> &other) const {
-		return p_iterator != other.p_iterator;
+		return !(*this == other);
 	}
 	ClauseType<BaseDefs> operator* () {
 		return ClauseType<BaseDefs>::fromIndex(*p_iterator);
 	}
 	
 private:
+	// advances to the next arena when the end of the current one is reached
+	void p_skipArenas() {
+		while(p_arena + 1 < ClauseSpaceStruct<BaseDefs>::kNumArenas
+				&& p_iterator == p_config->p_arenas[p_arena].indices.end()) {
+			p_arena++;
+			p_iterator = p_config->p_arenas[p_arena].indices.begin();
+		}
+	}
+
+	ClauseSpaceStruct<BaseDefs> *p_config;
+	int p_arena;
 	typename ClauseSpaceStruct<BaseDefs>::IndexIterator p_iterator;
 };
 
@@ -364,12 +854,35 @@ class ClauseLitIteratorStruct
 	: public std::iterator<std::forward_iterator_tag, LiteralType<BaseDefs>> {
 public:
 	ClauseLitIteratorStruct(ClauseSpaceStruct<BaseDefs> &config, ClauseType<BaseDefs> clause,
-			typename BaseDefs::ClauseLitIndex index) {
-		p_pointer = config.p_accessHead(clause.getIndex())->literal(index);
+			typename BaseDefs::ClauseLitIndex index) : p_skip1(nullptr), p_skip2(nullptr) {
+		auto head = config.p_accessHead(clause.getIndex());
+		if(!config.p_isShared(head)) {
+			p_pointer = head->literal(index);
+			return;
+		}
+
+		/* shared clauses are iterated in the order of the shared arena.
+		 * iterators that start at the second or third literal skip
+		 * the watched literals instead */
+		auto ref = config.p_sharedRef(head);
+		LiteralType<BaseDefs> *literals = config.p_sharedLiterals + ref.offset;
+		if(index == head->numLiterals) {
+			p_pointer = literals + index;
+			return;
+		}
+		SYS_ASSERT(SYS_ASRT_GENERAL, index <= 2);
+		if(index >= 1)
+			p_skip1 = literals + ref.watched[0];
+		if(index >= 2)
+			p_skip2 = literals + ref.watched[1];
+		p_pointer = literals;
+		p_skipWatched();
 	}
 
 	void operator++ () {
 		p_pointer++;
+		if(BaseDefs::kSharedClauses)
+			p_skipWatched();
 	}
 	bool operator== (const ClauseLitIteratorStruct<BaseDefs> &other) const {
 		return p_pointer == other.p_pointer;
@@ -382,16 +895,23 @@ public:
 	}
 	
 private:
+	void p_skipWatched() {
+		while(p_pointer == p_skip1 || p_pointer == p_skip2)
+			p_pointer++;
+	}
+
 	LiteralType<BaseDefs> *p_pointer;
+	LiteralType<BaseDefs> *p_skip1;
+	LiteralType<BaseDefs> *p_skip2;
 };
 
 template<typename BaseDefs>
 typename ClauseSpaceStruct<BaseDefs>::ClauseIterator ClauseSpaceStruct<BaseDefs>::begin() {
-	return ClauseIterator(*this, p_indices.begin());
+	return ClauseIterator(*this, kArenaOld, p_arenas[kArenaOld].indices.begin());
 }
 template<typename BaseDefs>
 typename ClauseSpaceStruct<BaseDefs>::ClauseIterator ClauseSpaceStruct<BaseDefs>::end() {
-	return ClauseIterator(*this, p_indices.end());
+	return ClauseIterator(*this, kNumArenas - 1, p_arenas[kNumArenas - 1].indices.end());
 }
 
 }; // namespace satuzk
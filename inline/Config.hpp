@@ -69,6 +69,11 @@ bool Config<BaseDefs, Hooks>::varIsFixed(Config<BaseDefs, Hooks>::Variable var)
 template<typename BaseDefs, typename Hooks>
 bool Config<BaseDefs, Hooks>::clauseContains(Config<BaseDefs, Hooks>::Clause clause,
 		Config<BaseDefs, Hooks>::Literal literal) {
+	if(p_clauseConfig.isPacked(clause)) {
+		std::vector<Literal> literals;
+		p_clauseConfig.unpackLiterals(clause, literals);
+		return std::find(literals.begin(), literals.end(), literal) != literals.end();
+	}
 	for(auto i = clauseBegin(clause); i != clauseEnd(clause); ++i)
 		if(*i == literal)
 			return true;
@@ -99,6 +104,18 @@ bool Config<BaseDefs, Hooks>::clauseAssigned(Config<BaseDefs, Hooks>::Clause cla
 
 template<typename BaseDefs, typename Hooks>
 bool Config<BaseDefs, Hooks>::clauseIsAntecedent(Config<BaseDefs, Hooks>::Clause clause) {
+	// frozen clauses are not installed; their literals may be packed
+	if(clauseIsFrozen(clause))
+		return false;
+
+	// any literal of a ternary clause can be implied by it
+	if(clauseIsTernary(clause)) {
+		for(ClauseLitIndex k = 0; k < 3; k++)
+			if(varImpliedBy(clauseGetLiteral(clause, k).variable(), clause))
+				return true;
+		return false;
+	}
+
 	Literal unit_lit = clauseGetFirst(clause);
 	Variable unit_var = unit_lit.variable();
 	auto antecedent = Antecedent::makeClause(clause);
@@ -109,26 +126,80 @@ bool Config<BaseDefs, Hooks>::clauseIsAntecedent(Config<BaseDefs, Hooks>::Clause
 }
 
 template<typename BaseDefs, typename Hooks>
-void Config<BaseDefs, Hooks>::ensureClauseSpace(unsigned int free_required) {
-	if(free_required < p_clauseConfig.p_allocator.getFreeSpace())
+bool Config<BaseDefs, Hooks>::varImpliedBy(Config<BaseDefs, Hooks>::Variable var,
+		Config<BaseDefs, Hooks>::Clause clause) {
+	if(!varAssigned(var))
+		return false;
+	Antecedent antecedent = varAntecedent(var);
+	if(antecedent == Antecedent::makeClause(clause))
+		return true;
+	if(!antecedent.isTernary() || !clauseIsTernary(clause))
+		return false;
+
+	// ternary antecedents store the inverses of the other two literals
+	Literal others[2];
+	int num_others = 0;
+	for(ClauseLitIndex k = 0; k < 3; k++) {
+		Literal literal = clauseGetLiteral(clause, k);
+		if(literal.variable() == var) {
+			if(!litTrue(literal))
+				return false;
+		}else if(num_others < 2) {
+			others[num_others++] = literal.inverse();
+		}
+	}
+	if(num_others != 2)
+		return false;
+	return (antecedent.getLiteral1() == others[0] && antecedent.getLiteral2() == others[1])
+			|| (antecedent.getLiteral1() == others[1] && antecedent.getLiteral2() == others[0]);
+}
+
+template<typename BaseDefs, typename Hooks>
+bool Config<BaseDefs, Hooks>::clauseFitsTernary(Config<BaseDefs, Hooks>::Clause clause) {
+	// lrat proofs require the clause of each antecedent
+	if(clauseLength(clause) != 3 || !clauseIsEssential(clause) || lratEnabled())
+		return false;
+	for(ClauseLitIndex k = 0; k < 3; k++)
+		if(!WatchlistEntry::ternaryFits(clauseGetLiteral(clause, k)))
+			return false;
+	return true;
+}
+
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::ensureClauseSpace(int arena, uint64_t free_required) {
+	auto &allocator = p_clauseConfig.p_arenas[arena].allocator;
+	if(free_required < allocator.getFreeSpace())
 		return;
 	
-	unsigned int used_estimate = p_clauseConfig.p_allocator.getUsedSpace();
-	unsigned int final_space = 1.5f * used_estimate + free_required;
+	uint64_t used_estimate = allocator.getUsedSpace();
+	uint64_t final_space = used_estimate + used_estimate / 2 + free_required;
+	// grow in smaller steps once memory gets scarce
+	if(memoryPressure() >= kPressureLow)
+		final_space = used_estimate + used_estimate / 8 + free_required;
+	final_space = limitClauseSpace(used_estimate + free_required, final_space);
 
 	if(opts.general.verbose >= 1)
 		std::cout << "c [GC    ] Extending clause space to " << (final_space / 1024) << " kb" << std::endl;
 
-	void *old_pointer = p_clauseConfig.p_allocator.getPointer();
-	void *new_pointer = operator new(final_space, std::nothrow);
-	if(new_pointer == NULL)
-		SYS_CRITICAL("Out of memory\n");
-	p_clauseConfig.p_allocator.moveTo(new_pointer, final_space);
-	operator delete(old_pointer);
+	// the clause space is an anonymous mapping that is grown by mremap()
+	// so that the clauses are neither copied nor resident twice
+	void *new_pointer = sysPageReallocate(allocator.getPointer(),
+			allocator.getTotalSpace(), final_space);
+	allocator.remapTo(new_pointer, final_space);
 
 	stat.general.clauseReallocs++;
 }
 
+template<typename BaseDefs, typename Hooks>
+uint64_t Config<BaseDefs, Hooks>::limitClauseSpace(uint64_t required, uint64_t desired) {
+	// clause indices cannot address more than kMaxBytes
+	if(required > ClauseConfig::kMaxBytes)
+		SYS_CRITICAL("Clause space exceeds the range of clause indices\n");
+	if(desired > ClauseConfig::kMaxBytes)
+		return ClauseConfig::kMaxBytes;
+	return desired;
+}
+
 template<typename BaseDefs, typename Hooks>
 typename Config<BaseDefs, Hooks>::ClauseLitIndex Config<BaseDefs, Hooks>::clauseLength(
 		Config<BaseDefs, Hooks>::Clause clause) {
@@ -195,17 +266,25 @@ bool Config<BaseDefs, Hooks>::clauseIsMarked(Config<BaseDefs, Hooks>::Clause cla
 
 // callback functor used during collectClauses()
 template<typename Config>
-class DelClauseCallback {
+class CompactClauseCallback {
 public:
-	DelClauseCallback(Config &config) : p_config(config) { }
+	CompactClauseCallback(Config &config) : p_config(config) { }
 
-	void onErase(typename Config::Clause from_index) {
-		SYS_ASSERT(SYS_ASRT_GENERAL, !p_config.p_clauseConfig.getFlagInstalled(from_index));
+	void onErase(typename Config::Clause clause) {
+		SYS_ASSERT(SYS_ASRT_GENERAL, !p_config.p_clauseConfig.getFlagInstalled(clause));
 	}
 
-	void onMove(typename Config::Clause from_index,
-			typename Config::Clause to_index) {
-		p_config.onClauseMove(from_index, to_index);
+	// essential and glue clauses are moved to the old arena
+	bool onPromote(typename Config::Clause clause) {
+		return p_config.clauseIsEssential(clause)
+				|| p_config.clauseGetLbd(clause) <= Config::kPromoteLbd;
+	}
+	void onReserve(int arena, uint64_t bytes) {
+		p_config.ensureClauseSpace(arena, bytes + Config::kClauseAlignment);
+	}
+
+	void onForward(typename Config::ClauseForwarding &forwarding) {
+		p_config.forwardClauses(forwarding);
 	}
 
 private:
@@ -213,27 +292,31 @@ private:
 };
 
 template<typename BaseDefs, typename Hooks>
-void Config<BaseDefs, Hooks>::collectClauses() {
-	// allocate new space for the clauses
-	unsigned int count_estimate = p_clauseConfig.numPresent();
-	unsigned int used_estimate = p_clauseConfig.presentBytes();
-	unsigned int space_estimate =  used_estimate + kClauseAlignment * count_estimate;
-	unsigned int final_space = 1.5f * space_estimate + 4 * 1024 * 1024;
-	
-	ClauseConfig new_config;
-	void *memory = operator new(final_space);
-	new_config.p_allocator.initMemory(memory, final_space);
-	
-	// copy them to the new space
-	DelClauseCallback<ThisType> callback(*this);
-	relocateClauses(p_clauseConfig, new_config, callback);
-
-	SYS_ASSERT(SYS_ASRT_GENERAL, new_config.p_allocator.getTotalSpace()
-			- new_config.p_allocator.getFreeSpace() < space_estimate);
-
-	// free the memory used by the old configuration
-	operator delete(p_clauseConfig.p_allocator.getPointer());
-	p_clauseConfig = std::move(new_config);
+void Config<BaseDefs, Hooks>::collectClauses(int arena) {
+	/* laying out the clauses and compacting the watch lists both
+	 * need a second copy of the memory for a moment. skip them if memory is
+	 * scarce, unless most of the watch list memory is wasted anyway */
+	bool scarce = memoryPressure() >= kPressureHigh;
+
+	// move the clauses inside the existing arena
+	CompactClauseCallback<ThisType> callback(*this);
+	compactClauses(p_clauseConfig, arena, callback);
+	if(opts.general.layoutClauses && !scarce)
+		layoutClauses(arena);
+
+	// return the pages behind the last clause to the os
+	auto &allocator = p_clauseConfig.p_arenas[arena].allocator;
+	uint64_t used_space = allocator.getUsedSpace();
+	sysPageRelease((char*)allocator.getPointer() + used_space,
+			allocator.getTotalSpace() - used_space);
+
+	/* the watch lists were just rewritten by forwardClauses(); move them to
+	 * fresh memory to get rid of fragmentation and to improve their locality */
+	if(arena == ClauseConfig::kArenaYoung && (!scarce
+			|| p_varConfig.watchWaste() > p_varConfig.watchMemory() / 2)) {
+		p_varConfig.watchCompact();
+		stat.general.watchCompacts++;
+	}
 
 	// rebuild occurrence lists
 	if(maintainOcclists) {
@@ -250,51 +333,118 @@ void Config<BaseDefs, Hooks>::collectClauses() {
 }
 
 template<typename BaseDefs, typename Hooks>
-void Config<BaseDefs, Hooks>::onClauseMove(Config<BaseDefs, Hooks>::Clause from_index,
-		Config<BaseDefs, Hooks>::Clause to_index) {
-	//std::cout << "Moving " << from_index << " to " << to_index << std::endl;
-	/* replace the clause in both watch lists.
-		NOTE: we cannot use clauseGetFirst on to_index! */
-	if(!p_clauseConfig.getFlagInstalled(from_index))
-		return;
-	
-	if(clauseLength(from_index) == 1) {
-		// there is nothing to fix in this case
-	}else if(clauseLength(from_index) == 2) {
-		Literal lit1 = clauseGetFirst(from_index);
-		Literal lit2 = clauseGetSecond(from_index);
-		watchReplaceBinary(lit1.inverse(), from_index, to_index);
-		watchReplaceBinary(lit2.inverse(), from_index, to_index);
-	}else{
-		Literal lit1 = clauseGetFirst(from_index);
-		Literal lit2 = clauseGetSecond(from_index);
-		watchReplaceClause(lit1.inverse(), from_index, to_index);
-		watchReplaceClause(lit2.inverse(), from_index, to_index);
-		
-		// update the antecedent if the clause was unit
-		Variable unit_var = lit1.variable();
-		auto from_antecedent = Antecedent::makeClause(from_index);
-		auto to_antecedent = Antecedent::makeClause(to_index);
-		//if(varAssigned(unit_var))
-		//	std::cout << "Antecedent: " << varAntecedent(unit_var).type
-		//			<< " / " << varAntecedent(unit_var).identifier.padding << std::endl;
-		if(from_antecedent == varAntecedent(unit_var))
-			p_varConfig.setAntecedent(unit_var, to_antecedent);
+void Config<BaseDefs, Hooks>::layoutClauses(int arena) {
+	/* walk the watch lists of the most frequently propagated literals first.
+	 * ternary entries do not access the clause */
+	std::vector<typename BaseDefs::LiteralIndex> literals;
+	p_varConfig.watchHotOrder(literals);
+	std::vector<Clause> order;
+	order.reserve(p_clauseConfig.p_arenas[arena].indices.size());
+	for(auto it = literals.begin(); it != literals.end(); ++it) {
+		Literal literal = Literal::fromIndex(*it);
+		for(auto i = p_varConfig.watchBegin(literal);
+				i != p_varConfig.watchEnd(literal); ++i)
+			if((*i).isLong())
+				order.push_back((*i).longGetClause());
+	}
+
+	// the clauses are copied so the arena needs a second mapping for a moment
+	auto &allocator = p_clauseConfig.p_arenas[arena].allocator;
+	void *old_pointer = allocator.getPointer();
+	uint64_t old_length = allocator.getTotalSpace();
+	// the alignment padding depends on the order of the clauses
+	uint64_t length = std::max(old_length,
+			allocator.getUsedSpace() + 2 * kClauseAlignment);
+	void *new_pointer = sysPageAllocate(length);
+
+	CompactClauseCallback<ThisType> callback(*this);
+	reorderClauses(p_clauseConfig, arena, order, new_pointer, length, callback);
+	sysPageDeallocate(old_pointer, old_length);
+}
+
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::forwardClauses(Config<BaseDefs, Hooks>::ClauseForwarding &forwarding) {
+	// replace the clauses in all watch lists
+	for(auto it = varsBegin(); it != varsEnd(); ++it) {
+		Literal literals[] = { (*it).oneLiteral(), (*it).zeroLiteral() };
+		for(int k = 0; k < 2; k++) {
+			for(auto i = p_varConfig.binaryBegin(literals[k]);
+					i != p_varConfig.binaryEnd(literals[k]); ++i)
+				(*i).binarySetClause(forwarding.lookup((*i).binaryGetClause()));
+			for(auto i = p_varConfig.watchBegin(literals[k]);
+					i != p_varConfig.watchEnd(literals[k]); ++i) {
+				if((*i).isLong())
+					(*i).longSetClause(forwarding.lookup((*i).longGetClause()));
+			}
+		}
 	}
+
+	// update the antecedents of assigned variables
+	for(auto it = varsBegin(); it != varsEnd(); ++it) {
+		if(!varAssigned(*it))
+			continue;
+		Antecedent antecedent = varAntecedent(*it);
+		if(antecedent.isClause())
+			p_varConfig.setAntecedent(*it,
+					Antecedent::makeClause(forwarding.lookup(antecedent.getClause())));
+	}
+
+	for(auto it = p_emptyClauses.begin(); it != p_emptyClauses.end(); ++it)
+		*it = forwarding.lookup(*it);
 }
 
 // checks whether a garbage collection is necessary
 template<typename BaseDefs, typename Hooks>
 void Config<BaseDefs, Hooks>::checkClauseGarbage() {
-	if(p_clauseConfig.numDeleted() > 0.5f * p_clauseConfig.numPresent())
-		collectClauses();
-	
-	unsigned int count_estimate = p_clauseConfig.numClauses();
-	unsigned int used_estimate = p_clauseConfig.presentBytes();
-	unsigned int space_estimate =  used_estimate + kClauseAlignment * count_estimate;
-	
-	if(p_clauseConfig.p_allocator.getUsedSpace() > 2 * space_estimate)
-		collectClauses();
+	// collect all garbage early when memory gets scarce
+	bool early = memoryPressure() >= kPressureHigh;
+
+	// the young arena is collected first as it may promote clauses to the old arena
+	for(int arena = ClauseConfig::kNumArenas - 1; arena >= 0; arena--) {
+		auto &info = p_clauseConfig.p_arenas[arena];
+		if(info.deletedClauses > 0.5f * info.presentClauses
+				|| (early && info.deletedClauses > 0)) {
+			collectClauses(arena);
+			continue;
+		}
+		
+		uint64_t count_estimate = info.indices.size();
+		uint64_t used_estimate = info.presentBytes;
+		uint64_t space_estimate =  used_estimate + kClauseAlignment * count_estimate;
+		
+		if(info.allocator.getUsedSpace() > 2 * space_estimate)
+			collectClauses(arena);
+	}
+}
+
+template<typename BaseDefs, typename Hooks>
+uint64_t Config<BaseDefs, Hooks>::memoryUsage() {
+	uint64_t bytes = p_clauseConfig.frozenStoreBytes()
+			+ p_clauseConfig.p_infos.size() * sizeof(typename ClauseConfig::ClauseInfo)
+			+ p_varConfig.watchMemory();
+	for(int arena = 0; arena < ClauseConfig::kNumArenas; arena++)
+		bytes += p_clauseConfig.p_arenas[arena].allocator.getUsedSpace();
+	return bytes;
+}
+
+template<typename BaseDefs, typename Hooks>
+int Config<BaseDefs, Hooks>::memoryPressure() {
+	uint64_t limit = opts.general.memLimit;
+	if(limit == 0)
+		return 0;
+
+	uint64_t usage = memoryUsage();
+	int pressure = 0;
+	if(usage > limit / 10 * 9) {
+		pressure = kPressureCritical;
+	}else if(usage > limit / 4 * 3) {
+		pressure = kPressureHigh;
+	}else if(usage > limit / 2)
+		pressure = kPressureLow;
+
+	if(pressure > stat.general.peakPressure)
+		stat.general.peakPressure = pressure;
+	return pressure;
 }
 
 template<typename BaseDefs, typename Hooks>
@@ -354,9 +504,16 @@ void Config<BaseDefs, Hooks>::watchInsertBinary(Config<BaseDefs, Hooks>::Literal
 		Config<BaseDefs, Hooks>::Literal implied,
 		Config<BaseDefs, Hooks>::Clause clause) {
 	WatchlistEntry new_entry;
-	new_entry.setBinary();
 	new_entry.binarySetImplied(implied);
 	new_entry.binarySetClause(clause);
+	p_varConfig.binaryInsert(literal, new_entry);
+}
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::watchInsertTernary(Config<BaseDefs, Hooks>::Literal literal,
+		Config<BaseDefs, Hooks>::Literal first,
+		Config<BaseDefs, Hooks>::Literal second) {
+	WatchlistEntry new_entry;
+	new_entry.ternarySetLiterals(first, second);
 	p_varConfig.watchInsert(literal, new_entry);
 }
 
@@ -377,11 +534,25 @@ void Config<BaseDefs, Hooks>::watchRemoveClause(Config<BaseDefs, Hooks>::Literal
 template<typename BaseDefs, typename Hooks>
 void Config<BaseDefs, Hooks>::watchRemoveBinary(Config<BaseDefs, Hooks>::Literal literal,
 		Config<BaseDefs, Hooks>::Clause clause) {
+	for(auto i = p_varConfig.binaryBegin(literal);
+			i != p_varConfig.binaryEnd(literal); ++i) {
+		if((*i).binaryGetClause() != clause)
+			continue;
+		p_varConfig.binaryErase(literal, i);
+		return;
+	}
+	SYS_CRITICAL("Clause not found\n");
+}
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::watchRemoveTernary(Config<BaseDefs, Hooks>::Literal literal,
+		Config<BaseDefs, Hooks>::Literal first,
+		Config<BaseDefs, Hooks>::Literal second) {
 	for(auto i = p_varConfig.watchBegin(literal);
 			i != p_varConfig.watchEnd(literal); ++i) {
-		if(!(*i).isBinary())
+		if(!(*i).isTernary())
 			continue;
-		if((*i).binaryGetClause() != clause)
+		if(!((*i).ternaryGetFirst() == first && (*i).ternaryGetSecond() == second)
+				&& !((*i).ternaryGetFirst() == second && (*i).ternaryGetSecond() == first))
 			continue;
 		p_varConfig.watchErase(literal, i);
 		return;
@@ -408,9 +579,7 @@ template<typename BaseDefs, typename Hooks>
 void Config<BaseDefs, Hooks>::watchReplaceBinary(Config<BaseDefs, Hooks>::Literal literal,
 		Config<BaseDefs, Hooks>::Clause clause,
 		Config<BaseDefs, Hooks>::Clause replacement) {
-	for(auto i = watchBegin(literal); i != watchEnd(literal); ++i) {
-		if(!(*i).isBinary())
-			continue;
+	for(auto i = binaryBegin(literal); i != binaryEnd(literal); ++i) {
 		if((*i).binaryGetClause() != clause)
 			continue;
 		(*i).binarySetClause(replacement);
@@ -422,10 +591,8 @@ void Config<BaseDefs, Hooks>::watchReplaceBinary(Config<BaseDefs, Hooks>::Litera
 template<typename BaseDefs, typename Hooks>
 bool Config<BaseDefs, Hooks>::watchContainsBinary(Config<BaseDefs, Hooks>::Literal literal,
 		Config<BaseDefs, Hooks>::Literal implied) {
-	for(auto i = p_varConfig.watchBegin(literal);
-			i != p_varConfig.watchEnd(literal); ++i) {
-		if(!(*i).isBinary())
-			continue;
+	for(auto i = p_varConfig.binaryBegin(literal);
+			i != p_varConfig.binaryEnd(literal); ++i) {
 		if((*i).binaryGetImplied() != implied)
 			continue;
 		return true;
@@ -433,6 +600,76 @@ bool Config<BaseDefs, Hooks>::watchContainsBinary(Config<BaseDefs, Hooks>::Liter
 	return false;
 }
 
+template<typename BaseDefs, typename Hooks>
+typename Config<BaseDefs, Hooks>::Clause Config<BaseDefs, Hooks>::watchFindBinary(
+		Config<BaseDefs, Hooks>::Literal literal,
+		Config<BaseDefs, Hooks>::Literal implied) {
+	for(auto i = p_varConfig.binaryBegin(literal);
+			i != p_varConfig.binaryEnd(literal); ++i) {
+		if((*i).binaryGetImplied() != implied)
+			continue;
+		return (*i).binaryGetClause();
+	}
+	SYS_CRITICAL("Clause not found\n");
+}
+
+template<typename BaseDefs, typename Hooks>
+typename Config<BaseDefs, Hooks>::Literal *Config<BaseDefs, Hooks>::clauseFindWatch(
+		Config<BaseDefs, Hooks>::Clause clause) {
+	if(p_clauseConfig.isShared(clause))
+		return sharedFindWatch(clause);
+
+	Literal *literals = p_clauseConfig.clauseLiterals(clause);
+	ClauseLitIndex length = clauseLength(clause);
+	Literal *end = literals + length;
+	if(!ClauseConfig::hasSearchPos(length)) {
+		Literal *found = p_varConfig.litFindNotFalse(literals + 2, end);
+		return found != end ? found : NULL;
+	}
+
+	// scan circularly, starting at the last position where a literal was found
+	Literal *position = literals + p_clauseConfig.clauseGetSearchPos(clause);
+	Literal *found = p_varConfig.litFindNotFalse(position, end);
+	if(found == end) {
+		found = p_varConfig.litFindNotFalse(literals + 2, position);
+		if(found == position)
+			return NULL;
+	}
+	p_clauseConfig.clauseSetSearchPos(clause, found - literals);
+	return found;
+}
+
+template<typename BaseDefs, typename Hooks>
+typename Config<BaseDefs, Hooks>::Literal *Config<BaseDefs, Hooks>::sharedFindWatch(
+		Config<BaseDefs, Hooks>::Clause clause) {
+	// the watched literals may be anywhere in the shared arena
+	Literal *literals = p_clauseConfig.sharedLiterals(clause);
+	Literal *watched1 = literals + p_clauseConfig.sharedWatched(clause, 0);
+	Literal *watched2 = literals + p_clauseConfig.sharedWatched(clause, 1);
+	Literal *end = literals + clauseLength(clause);
+
+	// scan circularly, starting at the last position where a literal was found
+	Literal *position = literals + p_clauseConfig.clauseGetSearchPos(clause);
+	Literal *from = position;
+	Literal *to = end;
+	while(true) {
+		Literal *found = p_varConfig.litFindNotFalse(from, to);
+		if(found == to) {
+			if(to == position)
+				return NULL;
+			from = literals;
+			to = position;
+			continue;
+		}
+		if(found == watched1 || found == watched2) {
+			from = found + 1;
+			continue;
+		}
+		p_clauseConfig.clauseSetSearchPos(clause, found - literals);
+		return found;
+	}
+}
+
 template<typename BaseDefs, typename Hooks>
 void Config<BaseDefs, Hooks>::occurConstruct() {
 	SYS_ASSERT(SYS_ASRT_GENERAL, !maintainOcclists);
@@ -469,11 +706,21 @@ template<typename BaseDefs, typename Hooks>
 void Config<BaseDefs, Hooks>::propagate() {
 	if(atConflict())
 		return;
-	while(p_propagateConfig.propagatePending()) {
+	PropagateCallback<ThisType> callback;
+	while(true) {
+		// binary implications are cheap: exhaust them on the whole trail
+		// before a single long watch list is visited
+		while(p_propagateConfig.binaryPending()) {
+			Literal literal = p_propagateConfig.nextBinary();
+			if(propagateBinary(*this, callback, literal))
+				return;
+		}
+		if(!p_propagateConfig.propagatePending())
+			break;
+
 		Literal literal = p_propagateConfig.nextPropagation();
 		stat.search.propagations++;
-		
-		PropagateCallback<ThisType> callback;
+		p_varConfig.watchVisit(literal);
 		if(propagateWatch(*this, callback, literal))
 			return;
 	}
@@ -604,11 +851,71 @@ void Config<BaseDefs, Hooks>::checkRestart() {
 
 template<typename BaseDefs, typename Hooks>
 template<typename Iterator>
-void Config<BaseDefs, Hooks>::inputClause(Config<BaseDefs, Hooks>::ClauseLitIndex length,
-		Iterator begin, Iterator end) {
-	Clause clause = allocClause(length, begin, end);
+typename Config<BaseDefs, Hooks>::Clause Config<BaseDefs, Hooks>::inputClause(
+		Config<BaseDefs, Hooks>::ClauseLitIndex length, Iterator begin, Iterator end) {
+	Clause clause = allocClause(length, begin, end, ClauseConfig::kArenaOld);
 	clauseSetEssential(clause);
 	installClause(clause);
+	return clause;
+}
+
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::inputShared(uint64_t num_clauses, const uint64_t *offsets,
+		typename BaseDefs::LiteralIndex *literals) {
+	p_clauseConfig.setSharedLiterals(reinterpret_cast<Literal*>(literals));
+	inputBulk(num_clauses, offsets, literals);
+}
+
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::inputBulk(uint64_t num_clauses, const uint64_t *offsets,
+		const typename BaseDefs::LiteralIndex *literals) {
+	static_assert(sizeof(Literal) == sizeof(typename BaseDefs::LiteralIndex),
+			"literals cannot be copied");
+	// clauses can only refer to the literals of the shared arena
+	bool share = (const void*)literals == (const void*)p_clauseConfig.p_sharedLiterals;
+
+	// allocate space for all clauses at once
+	uint64_t bytes = 0;
+	for(uint64_t i = 0; i < num_clauses; i++) {
+		ClauseLitIndex length = offsets[i + 1] - offsets[i];
+		if(share && ClauseConfig::worthSharing(length)) {
+			bytes += sizeof(typename ClauseConfig::ClauseHead)
+					+ sizeof(typename ClauseConfig::SharedRef) + kClauseAlignment;
+		}else bytes += p_clauseConfig.calcBytes(length) + kClauseAlignment;
+	}
+	auto &old_arena = p_clauseConfig.p_arenas[ClauseConfig::kArenaOld];
+	if(old_arena.allocator.getFreeSpace() <= bytes)
+		ensureClauseSpace(ClauseConfig::kArenaOld, bytes);
+	old_arena.indices.reserve(old_arena.indices.size() + num_clauses);
+
+	unsigned int sig_size = sizeof(ClauseSignature) * 8;
+	for(uint64_t i = 0; i < num_clauses; i++) {
+		ClauseLitIndex length = offsets[i + 1] - offsets[i];
+		const typename BaseDefs::LiteralIndex *begin = literals + offsets[i];
+
+		Clause clause;
+		if(share && ClauseConfig::worthSharing(length)) {
+			clause = p_clauseConfig.shareClause(length, offsets[i], ClauseConfig::kArenaOld);
+		}else{
+			clause = p_clauseConfig.allocClause(length, ClauseConfig::kArenaOld);
+			std::memcpy((void*)p_clauseConfig.clauseLiterals(clause), begin,
+					length * sizeof(Literal));
+		}
+		p_clauseConfig.clauseSetId(clause, ++p_lastClauseId);
+
+		ClauseSignature signature = 0;
+		for(ClauseLitIndex k = 0; k < length; k++)
+			signature |= (1 << (begin[k] % sig_size));
+		clauseSetSignature(clause, signature);
+
+		clauseSetEssential(clause);
+		installClause(clause);
+	}
+}
+
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::inputSkip() {
+	++p_lastClauseId;
 }
 
 template<typename BaseDefs, typename Hooks>
@@ -667,6 +974,10 @@ void Config<BaseDefs, Hooks>::freezeClause(Config<BaseDefs, Hooks>::Clause claus
 	SYS_ASSERT(SYS_ASRT_GENERAL, !p_clauseConfig.getFlagFrozen(clause));
 	uninstallClause(clause);
 	p_clauseConfig.setFlagFrozen(clause);
+	// shared clauses do not store their literals
+	if(ClauseConfig::worthPacking(clauseLength(clause))
+			&& !p_clauseConfig.isShared(clause))
+		p_clauseConfig.packClause(clause);
 }
 
 template<typename BaseDefs, typename Hooks>
@@ -674,13 +985,28 @@ void Config<BaseDefs, Hooks>::quickFreezeClause(Config<BaseDefs, Hooks>::Clause
 	SYS_ASSERT(SYS_ASRT_GENERAL, !p_clauseConfig.getFlagInstalled(clause));
 	SYS_ASSERT(SYS_ASRT_GENERAL, !p_clauseConfig.getFlagFrozen(clause));
 	p_clauseConfig.setFlagFrozen(clause);
+	// shared clauses do not store their literals
+	if(ClauseConfig::worthPacking(clauseLength(clause))
+			&& !p_clauseConfig.isShared(clause))
+		p_clauseConfig.packClause(clause);
 }
 
 template<typename BaseDefs, typename Hooks>
-void Config<BaseDefs, Hooks>::unfreezeClause(Config<BaseDefs, Hooks>::Clause clause) {
+typename Config<BaseDefs, Hooks>::Clause Config<BaseDefs, Hooks>::unfreezeClause(
+		Config<BaseDefs, Hooks>::Clause clause) {
 	SYS_ASSERT(SYS_ASRT_GENERAL, p_clauseConfig.getFlagFrozen(clause));
-	installClause(clause);
-	p_clauseConfig.unsetFlagFrozen(clause);
+	// decode the clause into a new record of its arena
+	Clause unpacked = clause;
+	if(p_clauseConfig.isPacked(clause)) {
+		int arena = ClauseConfig::arenaOf(clause);
+		ensureClauseSpace(arena, p_clauseConfig.calcBytes(clauseLength(clause))
+				+ kClauseAlignment);
+		unpacked = p_clauseConfig.unpackClause(clause, arena);
+	}
+
+	installClause(unpacked);
+	p_clauseConfig.unsetFlagFrozen(unpacked);
+	return unpacked;
 }
 
 template<typename BaseDefs, typename Hooks>
@@ -690,8 +1016,13 @@ bool Config<BaseDefs, Hooks>::clauseIsFrozen(Config<BaseDefs, Hooks>::Clause cla
 
 template<typename BaseDefs, typename Hooks>
 int Config<BaseDefs, Hooks>::calculatePsm(Config<BaseDefs, Hooks>::Clause clause) {
+	std::vector<Literal> literals;
+	if(p_clauseConfig.isPacked(clause)) {
+		p_clauseConfig.unpackLiterals(clause, literals);
+	}else literals.assign(clauseBegin(clause), clauseEnd(clause));
+
 	int psm = 0;
-	for(auto it = clauseBegin(clause); it != clauseEnd(clause); ++it) {
+	for(auto it = literals.begin(); it != literals.end(); ++it) {
 		Variable var = (*it).variable();
 		bool saved_one = p_varConfig.getVarFlagSaved(var);
 		if(((*it).isOneLiteral() && saved_one)
@@ -731,6 +1062,7 @@ void Config<BaseDefs, Hooks>::reduceClauses() {
 	// TODO: just backjump to a lower level instead of resetting
 	reset(); // reset the solver so that unfreeze works correctly
 	
+	int pressure = memoryPressure();
 	for(unsigned int i = 0; i < delete_queue.size(); i++) {
 		auto clause = delete_queue[i];
 		
@@ -739,9 +1071,13 @@ void Config<BaseDefs, Hooks>::reduceClauses() {
 			if(calculatePsm(clause) <= 3) {
 				unfreezeClause(clause);
 				stat.clauseRed.clauseUnfreezes++;
+			}else if(pressure >= kPressureCritical) {
+				deleteClause(clause);
+				stat.clauseRed.clauseDeletions++;
 			}
 		}else{
-			if(clauseGetLbd(clause) <= 8) {
+			// there is no room for frozen clauses under memory pressure
+			if(clauseGetLbd(clause) <= 8 && pressure < kPressureHigh) {
 				// freeze clauses that are good in general but bad under the current assignment
 				freezeClause(clause);
 				stat.clauseRed.clauseFreezes++;
@@ -761,10 +1097,12 @@ void Config<BaseDefs, Hooks>::reduceClauses() {
 
 template<typename BaseDefs, typename Hooks>
 void Config<BaseDefs, Hooks>::checkClauseReduction() {
+	// the interval between reductions shrinks with increasing memory pressure
+	int pressure = memoryPressure();
 	if(opts.clauseRed.model == kClauseRedAgile) {
 		state.clauseRed.agileCounter++;
 		if(state.clauseRed.agileCounter
-				>= state.clauseRed.agileInterval) {
+				>= (state.clauseRed.agileInterval >> pressure)) {
 			reduceClauses();
 			state.clauseRed.numClauseReds++;
 
@@ -773,7 +1111,7 @@ void Config<BaseDefs, Hooks>::checkClauseReduction() {
 		}
 	}else if(opts.clauseRed.model == kClauseRedGeometric) {
 		if(currentActiveClauses - currentEssentialClauses
-				>= state.clauseRed.geomSizeLimit)
+				>= (state.clauseRed.geomSizeLimit >> pressure))
 			reduceClauses();
 			state.clauseRed.numClauseReds++;
 
@@ -923,6 +1261,13 @@ void Config<BaseDefs, Hooks>::resolveConflict() {
 	stat.search.learnedLits += p_learnConfig.cutSize();
 	stat.search.minimizedLits += p_learnConfig.minSize();
 
+	// collect the lrat hints while the implication graph is still intact
+	if(lratEnabled()) {
+		p_lratHints.clear();
+		p_learnConfig.collectHints(*this, conflictBegin(), conflictEnd(), p_lratHints);
+		p_lratHints.push_back(conflictId());
+	}
+
 	Literal uip_literal = p_learnConfig.getMin(0);
 	Variable uip_var = uip_literal.variable();
 	
@@ -991,12 +1336,16 @@ void Config<BaseDefs, Hooks>::resolveConflict() {
 
 	// output the drat proof line for this clause
 	// TODO: move this to a "Hooks" function
-	if(opts.general.outputDratProof) {
-		for(auto it = p_learnConfig.beginMin(); it != p_learnConfig.endMin(); ++it) {
-			std::cout << (*it).toNumber();
-			std::cout << ' ';
+	if(p_proofWriter != nullptr) {
+		p_proofWriter->beginAdd(clauseGetId(learned));
+		for(auto it = p_learnConfig.beginMin(); it != p_learnConfig.endMin(); ++it)
+			p_proofWriter->writeLiteral((*it).toNumber());
+		if(p_proofWriter->isLrat()) {
+			p_proofWriter->beginHints();
+			for(auto it = p_lratHints.begin(); it != p_lratHints.end(); ++it)
+				p_proofWriter->writeHint(*it);
 		}
-		std::cout << "0" << std::endl;
+		p_proofWriter->endClause();
 	}
 	
 	if(kReportSample) {
@@ -1008,6 +1357,58 @@ void Config<BaseDefs, Hooks>::resolveConflict() {
 	p_learnConfig.reset();
 }
 
+/* ------------------------ PROOF FUNCTIONS ---------------------------- */
+
+template<typename BaseDefs, typename Hooks>
+uint64_t Config<BaseDefs, Hooks>::antecedentId(Config<BaseDefs, Hooks>::Variable var) {
+	Literal literal = litTrue(var.oneLiteral()) ? var.oneLiteral() : var.zeroLiteral();
+	Antecedent antecedent = varAntecedent(var);
+	if(antecedent.isClause()) {
+		return clauseGetId(antecedent.getClause());
+	}else if(antecedent.isBinary()) {
+		return clauseGetId(watchFindBinary(antecedent.getBinary(), literal));
+	}else if(antecedent.isDecision()) {
+		// only units are assigned as decisions on level 1
+		SYS_ASSERT(SYS_ASRT_GENERAL, varDeclevel(var) == 1);
+		SYS_ASSERT(SYS_ASRT_GENERAL, p_unitIds[literal.getIndex()] != 0);
+		return p_unitIds[literal.getIndex()];
+	}else SYS_CRITICAL("Illegal antecedent\n");
+}
+
+template<typename BaseDefs, typename Hooks>
+uint64_t Config<BaseDefs, Hooks>::conflictId() {
+	if(p_conflictDesc.isClause()) {
+		return clauseGetId(p_conflictDesc.getClause());
+	}else if(p_conflictDesc.isBinary()) {
+		return clauseGetId(watchFindBinary(p_conflictDesc.getLiteral1(),
+				p_conflictDesc.getLiteral2().inverse()));
+	}else if(p_conflictDesc.isFact()) {
+		return p_unitIds[p_conflictDesc.getLiteral1().getIndex()];
+	}else if(p_conflictDesc.isEmpty()) {
+		return clauseGetId(p_emptyClauses.front());
+	}else SYS_CRITICAL("Illegal conflict\n");
+}
+
+template<typename BaseDefs, typename Hooks>
+void Config<BaseDefs, Hooks>::proofEmptyClause() {
+	SYS_ASSERT(SYS_ASRT_GENERAL, isUnsatisfiable());
+	SYS_ASSERT(SYS_ASRT_GENERAL, p_proofWriter != nullptr);
+	
+	p_proofWriter->beginAdd(++p_lastClauseId);
+	if(lratEnabled()) {
+		p_lratHints.clear();
+		if(!p_conflictDesc.isEmpty())
+			p_learnConfig.collectHints(*this, conflictBegin(), conflictEnd(), p_lratHints);
+		p_lratHints.push_back(conflictId());
+		p_learnConfig.reset();
+
+		p_proofWriter->beginHints();
+		for(auto it = p_lratHints.begin(); it != p_lratHints.end(); ++it)
+			p_proofWriter->writeHint(*it);
+	}
+	p_proofWriter->endClause();
+}
+
 /* --------------------- ASSUMPTION FUNCTIONS -------------------------- */
 
 template<typename BaseDefs, typename Hooks>
@@ -1041,13 +1442,14 @@ bool Config<BaseDefs, Hooks>::isAssumed(Config<BaseDefs, Hooks>::Literal literal
 template<typename BaseDefs, typename Hooks>
 template<typename Iterator>
 typename Config<BaseDefs, Hooks>::Clause Config<BaseDefs, Hooks>::allocClause(
-		Config<BaseDefs, Hooks>::ClauseLitIndex length, Iterator begin, Iterator end) {
-	unsigned int mem_estimate = p_clauseConfig.calcBytes(length)
+		Config<BaseDefs, Hooks>::ClauseLitIndex length, Iterator begin, Iterator end,
+		int arena) {
+	uint64_t mem_estimate = p_clauseConfig.calcBytes(length)
 			+ kClauseAlignment;
 	
 	// ensure that there is enough free space for a new clause
-	if(p_clauseConfig.p_allocator.getFreeSpace() < mem_estimate)
-		ensureClauseSpace(mem_estimate);
+	if(p_clauseConfig.p_arenas[arena].allocator.getFreeSpace() < mem_estimate)
+		ensureClauseSpace(arena, mem_estimate);
 	
 	// sanity check
 	/*for(auto i = begin; i != end; ++i) {
@@ -1060,7 +1462,8 @@ typename Config<BaseDefs, Hooks>::Clause Config<BaseDefs, Hooks>::allocClause(
 		}
 	}*/
 	
-	Clause clause = p_clauseConfig.allocClause(length);
+	Clause clause = p_clauseConfig.allocClause(length, arena);
+	p_clauseConfig.clauseSetId(clause, ++p_lastClauseId);
 
 	ClauseSignature signature = 0;
 	unsigned int sig_size = sizeof(ClauseSignature) * 8;
@@ -1087,20 +1490,33 @@ void Config<BaseDefs, Hooks>::deleteClause(Clause clause) {
 	SYS_ASSERT(SYS_ASRT_GENERAL, !p_clauseConfig.isDeleted(clause));
 	p_clauseConfig.deleteClause(clause);
 	
+	// the literals of frozen clauses may be packed
+	std::vector<Literal> packed_literals;
+	Literal *literals_begin;
+	if(p_clauseConfig.isPacked(clause)) {
+		p_clauseConfig.unpackLiterals(clause, packed_literals);
+		literals_begin = packed_literals.data();
+	}else if(p_clauseConfig.isShared(clause)) {
+		literals_begin = p_clauseConfig.sharedLiterals(clause);
+	}else literals_begin = p_clauseConfig.clauseLiterals(clause);
+	Literal *literals_end = literals_begin + clauseLength(clause);
+
 	if(maintainOcclists) {
-		for(auto i = clauseBegin(clause); i != clauseEnd(clause); ++i)
+		for(Literal *i = literals_begin; i != literals_end; ++i)
 			p_varConfig.occurRemove(*i, clause);
 	}
 	
 	// output the drat proof line for this clause
 	// TODO: move this to a "Hooks" function
-	if(opts.general.outputDratProof) {
-		std::cout << "d ";
-		for(auto it = clauseBegin(clause); it != clauseEnd(clause); ++it) {
-			std::cout << (*it).toNumber();
-			std::cout << ' ';
+	if(p_proofWriter != nullptr) {
+		p_proofWriter->beginDelete(p_lastClauseId);
+		if(p_proofWriter->isLrat()) {
+			p_proofWriter->writeHint(clauseGetId(clause));
+		}else{
+			for(Literal *it = literals_begin; it != literals_end; ++it)
+				p_proofWriter->writeLiteral((*it).toNumber());
 		}
-		std::cout << "0" << std::endl;
+		p_proofWriter->endClause();
 	}
 	
 	stat.general.deletedClauses++;
@@ -1117,11 +1533,24 @@ void Config<BaseDefs, Hooks>::installClause(Config<BaseDefs, Hooks>::Clause clau
 	}else if(clauseLength(clause) == 1) {
 		Literal lit = clauseGetFirst(clause);
 		p_unitClauses.push_back(lit);
+		if(lratEnabled()) {
+			if(p_unitIds.size() <= lit.getIndex())
+				p_unitIds.resize(lit.getIndex() + 1, 0);
+			p_unitIds[lit.getIndex()] = clauseGetId(clause);
+		}
 	}else if(clauseLength(clause) == 2) {
 		Literal lit1 = clauseGetFirst(clause);
 		Literal lit2 = clauseGetSecond(clause);
 		watchInsertBinary(lit1.inverse(), lit2, clause);
 		watchInsertBinary(lit2.inverse(), lit1, clause);
+	}else if(clauseFitsTernary(clause)) {
+		Literal lit1 = clauseGetLiteral(clause, 0);
+		Literal lit2 = clauseGetLiteral(clause, 1);
+		Literal lit3 = clauseGetLiteral(clause, 2);
+		watchInsertTernary(lit1.inverse(), lit2, lit3);
+		watchInsertTernary(lit2.inverse(), lit1, lit3);
+		watchInsertTernary(lit3.inverse(), lit1, lit2);
+		p_clauseConfig.setFlagTernary(clause);
 	}else{
 		Literal lit1 = clauseGetFirst(clause);
 		Literal lit2 = clauseGetSecond(clause);
@@ -1147,6 +1576,14 @@ void Config<BaseDefs, Hooks>::uninstallClause(Config<BaseDefs, Hooks>::Clause cl
 		Literal lit2 = clauseGetSecond(clause);
 		watchRemoveBinary(lit1.inverse(), clause);
 		watchRemoveBinary(lit2.inverse(), clause);
+	}else if(clauseIsTernary(clause)) {
+		Literal lit1 = clauseGetLiteral(clause, 0);
+		Literal lit2 = clauseGetLiteral(clause, 1);
+		Literal lit3 = clauseGetLiteral(clause, 2);
+		watchRemoveTernary(lit1.inverse(), lit2, lit3);
+		watchRemoveTernary(lit2.inverse(), lit1, lit3);
+		watchRemoveTernary(lit3.inverse(), lit1, lit2);
+		p_clauseConfig.unsetFlagTernary(clause);
 	}else{
 		Literal lit1 = clauseGetFirst(clause);
 		Literal lit2 = clauseGetSecond(clause);
@@ -7,6 +7,7 @@ ConflictStruct<BaseDefs> ConflictStruct<BaseDefs>::makeNone() {
 	result.type = kTypeNone;
 	result.padding.p1 = 0;
 	result.padding.p2 = 0;
+	result.padding.p3 = 0;
 	return result;
 }
 template<typename BaseDefs>
@@ -14,6 +15,7 @@ ConflictStruct<BaseDefs> ConflictStruct<BaseDefs>::makeClause(Clause clause) {
 	ConflictStruct<BaseDefs> result;
 	result.padding.p1 = 0;
 	result.padding.p2 = 0;
+	result.padding.p3 = 0;
 	result.type = kTypeClause;
 	result.clause = clause.getIndex();
 	return result;
@@ -23,16 +25,28 @@ ConflictStruct<BaseDefs> ConflictStruct<BaseDefs>::makeBinary(Literal literal1,
 	ConflictStruct<BaseDefs> result;
 	result.padding.p1 = 0;
 	result.padding.p2 = 0;
+	result.padding.p3 = 0;
 	result.type = kTypeBinary;
 	result.literals.l1 = literal1.getIndex();
 	result.literals.l2 = literal2.getIndex();
 	return result;
 }
 template<typename BaseDefs>
+ConflictStruct<BaseDefs> ConflictStruct<BaseDefs>::makeTernary(Literal literal1,
+		Literal literal2, Literal literal3) {
+	ConflictStruct<BaseDefs> result;
+	result.type = kTypeTernary;
+	result.literals.l1 = literal1.getIndex();
+	result.literals.l2 = literal2.getIndex();
+	result.literals.l3 = literal3.getIndex();
+	return result;
+}
+template<typename BaseDefs>
 ConflictStruct<BaseDefs> ConflictStruct<BaseDefs>::makeFact(Literal literal) {
 	ConflictStruct<BaseDefs> result;
 	result.padding.p1 = 0;
 	result.padding.p2 = 0;
+	result.padding.p3 = 0;
 	result.type = kTypeFact;
 	result.literals.l1 = literal.getIndex();
 	return result;
@@ -42,6 +56,7 @@ ConflictStruct<BaseDefs> ConflictStruct<BaseDefs>::makeEmpty() {
 	ConflictStruct<BaseDefs> result;
 	result.padding.p1 = 0;
 	result.padding.p2 = 0;
+	result.padding.p3 = 0;
 	result.type = kTypeEmpty;
 	return result;
 }
@@ -72,6 +87,10 @@ bool ConflictStruct<BaseDefs>::isBinary() {
 	return type == kTypeBinary;
 }
 template<typename BaseDefs>
+bool ConflictStruct<BaseDefs>::isTernary() {
+	return type == kTypeTernary;
+}
+template<typename BaseDefs>
 bool ConflictStruct<BaseDefs>::isFact() {
 	return type == kTypeFact;
 }
@@ -92,6 +111,10 @@ template<typename BaseDefs>
 typename ConflictStruct<BaseDefs>::Literal ConflictStruct<BaseDefs>::getLiteral2() {
 	return Literal::fromIndex(literals.l2);
 }
+template<typename BaseDefs>
+typename ConflictStruct<BaseDefs>::Literal ConflictStruct<BaseDefs>::getLiteral3() {
+	return Literal::fromIndex(literals.l3);
+}
 
 }; // namespace satuzk
 
@@ -0,0 +1,344 @@
+
+#include <mutex>
+#include <condition_variable>
+
+#ifdef FEATURE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef FEATURE_LZMA
+#include <lzma.h>
+#endif
+#ifdef FEATURE_BZIP2
+#include <bzlib.h>
+#endif
+
+namespace sys {
+
+enum CompressFormat {
+	kCompressNone,
+	kCompressGzip,
+	kCompressXz,
+	kCompressBzip2
+};
+
+// number of bytes required by detectCompression()
+static const size_t kCompressMagicLength = 6;
+
+// detects the compression format by looking at the magic bytes
+inline CompressFormat detectCompression(const char *data, size_t length) {
+	const unsigned char *bytes = (const unsigned char*)data;
+	if(length >= 2 && bytes[0] == 0x1F && bytes[1] == 0x8B)
+		return kCompressGzip;
+	if(length >= 6 && bytes[0] == 0xFD && bytes[1] == '7' && bytes[2] == 'z'
+			&& bytes[3] == 'X' && bytes[4] == 'Z' && bytes[5] == 0)
+		return kCompressXz;
+	if(length >= 3 && bytes[0] == 'B' && bytes[1] == 'Z' && bytes[2] == 'h')
+		return kCompressBzip2;
+	return kCompressNone;
+}
+
+#ifdef FEATURE_ZLIB
+class GzipCodec {
+public:
+	GzipCodec() {
+		std::memset(&p_stream, 0, sizeof(z_stream));
+		// 15 + 32 enables automatic gzip header detection
+		if(inflateInit2(&p_stream, 15 + 32) != Z_OK)
+			throw std::runtime_error("Could not initialize zlib");
+	}
+	~GzipCodec() {
+		inflateEnd(&p_stream);
+	}
+
+	// prepares the codec for another concatenated stream
+	void reset() {
+		inflateReset(&p_stream);
+	}
+
+	// returns true if the end of the compressed stream was reached
+	bool decode(const char *&in, size_t &in_length,
+			char *&out, size_t &out_length, bool input_eof) {
+		p_stream.next_in = (Bytef*)in;
+		p_stream.avail_in = in_length;
+		p_stream.next_out = (Bytef*)out;
+		p_stream.avail_out = out_length;
+		int result = inflate(&p_stream, Z_NO_FLUSH);
+		in = (const char*)p_stream.next_in;
+		in_length = p_stream.avail_in;
+		out = (char*)p_stream.next_out;
+		out_length = p_stream.avail_out;
+
+		if(result == Z_STREAM_END)
+			return true;
+		if(result != Z_OK && result != Z_BUF_ERROR)
+			throw std::runtime_error("Could not decompress gzip input");
+		return false;
+	}
+
+private:
+	z_stream p_stream;
+};
+#endif
+
+#ifdef FEATURE_LZMA
+class XzCodec {
+public:
+	XzCodec() : p_stream(LZMA_STREAM_INIT) {
+		init();
+	}
+	~XzCodec() {
+		lzma_end(&p_stream);
+	}
+
+	void reset() {
+		lzma_end(&p_stream);
+		init();
+	}
+
+	bool decode(const char *&in, size_t &in_length,
+			char *&out, size_t &out_length, bool input_eof) {
+		p_stream.next_in = (const uint8_t*)in;
+		p_stream.avail_in = in_length;
+		p_stream.next_out = (uint8_t*)out;
+		p_stream.avail_out = out_length;
+		lzma_ret result = lzma_code(&p_stream, input_eof ? LZMA_FINISH : LZMA_RUN);
+		in = (const char*)p_stream.next_in;
+		in_length = p_stream.avail_in;
+		out = (char*)p_stream.next_out;
+		out_length = p_stream.avail_out;
+
+		if(result == LZMA_STREAM_END)
+			return true;
+		if(result != LZMA_OK && result != LZMA_BUF_ERROR)
+			throw std::runtime_error("Could not decompress xz input");
+		return false;
+	}
+
+private:
+	void init() {
+		// LZMA_CONCATENATED handles multiple concatenated streams internally
+		if(lzma_stream_decoder(&p_stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+			throw std::runtime_error("Could not initialize liblzma");
+	}
+
+	lzma_stream p_stream;
+};
+#endif
+
+#ifdef FEATURE_BZIP2
+class Bzip2Codec {
+public:
+	Bzip2Codec() {
+		init();
+	}
+	~Bzip2Codec() {
+		BZ2_bzDecompressEnd(&p_stream);
+	}
+
+	void reset() {
+		BZ2_bzDecompressEnd(&p_stream);
+		init();
+	}
+
+	bool decode(const char *&in, size_t &in_length,
+			char *&out, size_t &out_length, bool input_eof) {
+		p_stream.next_in = (char*)in;
+		p_stream.avail_in = in_length;
+		p_stream.next_out = out;
+		p_stream.avail_out = out_length;
+		int result = BZ2_bzDecompress(&p_stream);
+		in = p_stream.next_in;
+		in_length = p_stream.avail_in;
+		out = p_stream.next_out;
+		out_length = p_stream.avail_out;
+
+		if(result == BZ_STREAM_END)
+			return true;
+		if(result != BZ_OK)
+			throw std::runtime_error("Could not decompress bzip2 input");
+		return false;
+	}
+
+private:
+	void init() {
+		std::memset(&p_stream, 0, sizeof(bz_stream));
+		if(BZ2_bzDecompressInit(&p_stream, 0, 0) != BZ_OK)
+			throw std::runtime_error("Could not initialize libbz2");
+	}
+
+	bz_stream p_stream;
+};
+#endif
+
+// decompresses a file descriptor on a background thread.
+// decompressed data is passed to the consumer through two buffers
+// so that decompression overlaps with the consumer's work
+class Decompressor {
+public:
+	// prefix contains data that was already read from fd
+	Decompressor(int fd, CompressFormat format,
+			const char *prefix, size_t prefix_length)
+			: p_fd(fd), p_format(format), p_prefix(prefix, prefix + prefix_length),
+			p_consumeIndex(0), p_holding(false), p_finished(false), p_cancel(false) {
+		for(int i = 0; i < 2; i++) {
+			p_blocks[i].data = new char[kBlockSize];
+			p_blocks[i].length = 0;
+			p_blocks[i].full = false;
+		}
+		p_thread = std::thread(&Decompressor::run, this);
+	}
+	~Decompressor() {
+		{
+			std::lock_guard<std::mutex> lock(p_mutex);
+			p_cancel = true;
+		}
+		p_condition.notify_all();
+		p_thread.join();
+		for(int i = 0; i < 2; i++)
+			delete[] p_blocks[i].data;
+	}
+	Decompressor(const Decompressor &other) = delete;
+	Decompressor &operator= (const Decompressor &other) = delete;
+
+	// returns the next block of decompressed data.
+	// the block stays valid until the next call. returns 0 at the end of input
+	size_t next(const char *&data) {
+		std::unique_lock<std::mutex> lock(p_mutex);
+		if(p_holding) {
+			p_blocks[p_consumeIndex].full = false;
+			p_consumeIndex ^= 1;
+			p_holding = false;
+			p_condition.notify_all();
+		}
+		if(p_finished)
+			return 0;
+
+		Block &block = p_blocks[p_consumeIndex];
+		while(!block.full)
+			p_condition.wait(lock);
+		if(p_error)
+			std::rethrow_exception(p_error);
+		if(block.length == 0) {
+			p_finished = true;
+			return 0;
+		}
+		p_holding = true;
+		data = block.data;
+		return block.length;
+	}
+
+private:
+	static const size_t kBlockSize = 1024 * 1024;
+	static const size_t kInputSize = 256 * 1024;
+
+	struct Block {
+		char *data;
+		size_t length;
+		bool full;
+	};
+
+	void run() {
+		try {
+			switch(p_format) {
+#ifdef FEATURE_ZLIB
+			case kCompressGzip: produce<GzipCodec>(); break;
+#endif
+#ifdef FEATURE_LZMA
+			case kCompressXz: produce<XzCodec>(); break;
+#endif
+#ifdef FEATURE_BZIP2
+			case kCompressBzip2: produce<Bzip2Codec>(); break;
+#endif
+			default:
+				throw std::runtime_error("Compression format is not supported by this build");
+			}
+		}catch(...) {
+			std::lock_guard<std::mutex> lock(p_mutex);
+			p_error = std::current_exception();
+			// wake up the consumer even if it is waiting for the other block
+			p_blocks[0].full = true;
+			p_blocks[1].full = true;
+			p_condition.notify_all();
+		}
+	}
+
+	template<typename Codec>
+	void produce() {
+		Codec codec;
+		std::vector<char> input(kInputSize);
+		const char *in = p_prefix.data();
+		size_t in_length = p_prefix.size();
+		bool input_eof = false;
+		bool stream_end = false;
+		int index = 0;
+
+		while(true) {
+			// wait until the consumer has released the block
+			{
+				std::unique_lock<std::mutex> lock(p_mutex);
+				while(p_blocks[index].full && !p_cancel)
+					p_condition.wait(lock);
+				if(p_cancel)
+					return;
+			}
+
+			char *out = p_blocks[index].data;
+			size_t out_length = kBlockSize;
+			while(out_length > 0 && !stream_end) {
+				if(in_length == 0 && !input_eof)
+					input_eof = !refill(input, in, in_length);
+
+				size_t prev_in = in_length;
+				size_t prev_out = out_length;
+				if(codec.decode(in, in_length, out, out_length, input_eof)) {
+					// multiple compressed streams may be concatenated
+					if(in_length == 0 && !input_eof)
+						input_eof = !refill(input, in, in_length);
+					if(in_length == 0) {
+						stream_end = true;
+					}else codec.reset();
+				}else if(input_eof && in_length == prev_in && out_length == prev_out) {
+					throw std::runtime_error("Compressed input is truncated");
+				}
+			}
+
+			// pass the block to the consumer. an empty block signals the end
+			{
+				std::lock_guard<std::mutex> lock(p_mutex);
+				p_blocks[index].length = kBlockSize - out_length;
+				p_blocks[index].full = true;
+				p_condition.notify_all();
+			}
+			index ^= 1;
+			if(stream_end && out_length == kBlockSize)
+				return;
+		}
+	}
+
+	// reads the next chunk of compressed input; returns false at the end of input
+	bool refill(std::vector<char> &input, const char *&in, size_t &in_length) {
+		ssize_t len = ::read(p_fd, input.data(), input.size());
+		if(len == -1)
+			throw std::runtime_error("Could not read input");
+		in = input.data();
+		in_length = len;
+		return len != 0;
+	}
+
+	int p_fd;
+	CompressFormat p_format;
+	std::vector<char> p_prefix;
+
+	std::thread p_thread;
+	std::mutex p_mutex;
+	std::condition_variable p_condition;
+	std::exception_ptr p_error;
+
+	Block p_blocks[2];
+	int p_consumeIndex;
+	bool p_holding;
+	bool p_finished;
+	bool p_cancel;
+};
+
+}; // namespace sys
@@ -1,10 +1,36 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 class BaseParser {
 public:
-	BaseParser(int fd) : p_fd(fd),
+	BaseParser(int fd) : p_fd(fd), p_decompressor(nullptr), p_data(p_readBuffer),
 			p_readPointer(0), p_readLimit(0), p_eof(false) {
-		read();
+		// read enough data to detect compressed input
+		while(p_readLimit < (int)sys::kCompressMagicLength) {
+			ssize_t len = ::read(p_fd, p_readBuffer + p_readLimit,
+					kReadBufferSize - p_readLimit);
+			if(len == -1)
+				throw std::runtime_error("Could not read input");
+			if(len == 0)
+				break;
+			p_readLimit += len;
+		}
+
+		sys::CompressFormat format = sys::detectCompression(p_readBuffer, p_readLimit);
+		if(format != sys::kCompressNone) {
+			p_decompressor = new sys::Decompressor(p_fd, format,
+					p_readBuffer, p_readLimit);
+			p_readLimit = 0;
+			read();
+		}else if(p_readLimit == 0) {
+			p_eof = true;
+		}
 	}
+	~BaseParser() {
+		delete p_decompressor;
+	}
+	BaseParser(const BaseParser &other) = delete;
+	BaseParser &operator= (const BaseParser &other) = delete;
 
 	//---------------------------------------------------------------
 	// low level functions
@@ -12,9 +38,14 @@ public:
 
 	void read() {
 		assert(p_readPointer == p_readLimit);
-		ssize_t len = ::read(p_fd, p_readBuffer, kReadBufferSize);
-		if(len == -1)
-			throw std::runtime_error("Could not read input");
+		ssize_t len;
+		if(p_decompressor != nullptr) {
+			len = p_decompressor->next(p_data);
+		}else{
+			len = ::read(p_fd, p_readBuffer, kReadBufferSize);
+			if(len == -1)
+				throw std::runtime_error("Could not read input");
+		}
 		if(len == 0)
 			p_eof = true;
 		p_readLimit = len;
@@ -30,7 +61,7 @@ public:
 	}
 	char fetch() {
 		assert(p_readPointer < p_readLimit);
-		return p_readBuffer[p_readPointer];
+		return p_data[p_readPointer];
 	}
 	
 	//---------------------------------------------------------------
@@ -110,8 +141,12 @@ private:
 	static const int kTempBufferSize = 1024;
 	
 	int p_fd;
+	// decompresses the input if it is compressed
+	sys::Decompressor *p_decompressor;
 	
 	char p_readBuffer[kReadBufferSize];
+	// points either to p_readBuffer or to a block of decompressed data
+	const char *p_data;
 	int p_readPointer;
 	int p_readLimit;
 	bool p_eof;
@@ -120,12 +155,325 @@ private:
 	int p_tempLength;
 };
 
+// parser backend that tokenizes a memory mapped file in-place.
+// it can also operate on an arbitrary range of memory
+class MappedParser {
+public:
+	MappedParser(int fd) : p_mapping(nullptr), p_mapLength(0),
+			p_begin(nullptr), p_end(nullptr), p_wordLength(0) {
+		struct stat st;
+		if(fstat(fd, &st) != 0)
+			throw std::runtime_error("Could not stat input");
+		p_mapLength = st.st_size;
+
+		// mmap() does not support empty mappings
+		if(p_mapLength == 0)
+			return;
+		p_mapping = mmap(nullptr, p_mapLength, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p_mapping == MAP_FAILED)
+			throw std::runtime_error("Could not map input");
+		madvise(p_mapping, p_mapLength, MADV_SEQUENTIAL);
+
+		p_begin = (const char*)p_mapping;
+		p_end = p_begin + p_mapLength;
+	}
+	MappedParser(const char *begin, const char *end)
+			: p_mapping(nullptr), p_mapLength(0),
+			p_begin(begin), p_end(end), p_wordLength(0) { }
+	~MappedParser() {
+		if(p_mapping != nullptr)
+			munmap(p_mapping, p_mapLength);
+	}
+	MappedParser(const MappedParser &other) = delete;
+	MappedParser &operator= (const MappedParser &other) = delete;
+
+	//---------------------------------------------------------------
+	// low level functions
+	//---------------------------------------------------------------
+
+	void consume() {
+		assert(p_begin < p_end);
+		p_begin++;
+	}
+	bool atEndOfFile() {
+		return p_begin == p_end;
+	}
+	char fetch() {
+		assert(p_begin < p_end);
+		return *p_begin;
+	}
+
+	const char *position() {
+		return p_begin;
+	}
+	const char *limit() {
+		return p_end;
+	}
+	
+	//---------------------------------------------------------------
+	// high level functions
+	//---------------------------------------------------------------
+
+	bool checkSpace() {
+		return fetch() == ' ' || fetch() == '\t';
+	}
+	bool checkBreak() {
+		return fetch() == '\n' || fetch() == '\r';
+	}
+	
+	void skipSpace() {
+		while(!atEndOfFile() && checkSpace())
+			consume();
+	}
+	void skipSpaceOrBreak() {
+		while(!atEndOfFile() && (checkSpace() || checkBreak()))
+			consume();
+	}
+	void skipUntilBreakOrEnd() {
+		while(!atEndOfFile() && !checkBreak())
+			consume();
+		if(!atEndOfFile())
+			consume();
+	}
+	
+	void forceBreakOrEnd() {
+		if(atEndOfFile())
+			return;
+		if(!checkBreak())
+			throw std::runtime_error("Expected end-of-line");
+		consume();
+	}
+
+	// the word is not copied; we only remember its position
+	void readWord() {
+		p_word = p_begin;
+		while(!atEndOfFile() && !checkSpace() && !checkBreak())
+			consume();
+		p_wordLength = p_begin - p_word;
+	}
+	bool bufferMatch(const char *string) {
+		for(int i = 0; string[i] != 0; i++) {
+			if(i >= p_wordLength)
+				return false;
+			if(string[i] != p_word[i])
+				return false;
+		}
+		return true;
+	}
+	int64_t bufferGetInt() {
+		int64_t num = 0;
+		bool neg = false;
+		const char *p = p_word;
+		const char *limit = p_word + p_wordLength;
+		
+		if(p_wordLength == 0)
+			throw std::runtime_error("Expected number (empty buffer)");
+		if(*p == '-') {
+			neg = true;
+			p++;
+		}
+		while(p < limit) {
+			if(!(*p >= '0' && *p <= '9'))
+				throw std::runtime_error("Expected number (illegal char)");
+			num = num * 10 + (*p - '0');
+			p++;
+		}
+		return neg ? -num : num;
+	}
+
+private:
+	void *p_mapping;
+	size_t p_mapLength;
+
+	const char *p_begin;
+	const char *p_end;
+
+	const char *p_word;
+	ptrdiff_t p_wordLength;
+};
+
+// normalizes clauses before they are passed to the hooks:
+// removes duplicate literals, drops tautologies and drops clauses
+// that are identical to a previous clause.
+// literals are marked in a timestamp array so that each clause is
+// processed in time linear in its length.
+// identical clauses are found through a hash table that refers to the
+// clauses stored by the hooks: onClause() returns a handle for each clause
+// and storedLength() / storedLiteral() read the clause back
 template<typename Hooks>
+class ClauseNormalizer {
+public:
+	ClauseNormalizer(Hooks &hooks, bool detect_duplicates) : p_hooks(hooks),
+			p_numVars(0), p_timestamp(0), p_detectDuplicates(detect_duplicates),
+			p_numEntries(0), p_hash(kEmptyHash), p_slot(0) {
+		if(p_detectDuplicates)
+			p_table.resize(kInitialTableSize);
+	}
+
+	// called for the problem line; literals must not exceed num_vars
+	void declareVariables(long num_vars) {
+		if(num_vars < 0)
+			throw std::runtime_error("Illegal number of variables");
+		p_numVars = num_vars;
+		p_stamps.assign(2 * (size_t)num_vars + 2, 0);
+		p_timestamp = 0;
+	}
+
+	// returns false if the clause should be dropped.
+	// otherwise the clause must be passed to insert() after it was stored
+	bool normalize(std::vector<long> &clause) {
+		nextTimestamp();
+
+		auto k = clause.begin();
+		uint64_t hash = 0;
+		for(auto i = clause.begin(); i != clause.end(); ++i) {
+			if(*i > p_numVars || *i < -p_numVars)
+				throw std::runtime_error("Illegal literal");
+			size_t index = literalIndex(*i);
+			if(p_stamps[index] == p_timestamp)
+				continue;
+			if(p_stamps[index ^ 1] == p_timestamp)
+				return false;
+			p_stamps[index] = p_timestamp;
+			hash += mixLiteral(index);
+			*k = *i;
+			k++;
+		}
+		clause.resize(k - clause.begin());
+		if(!p_detectDuplicates)
+			return true;
+
+		// look for an identical clause. the hash is independent of
+		// the literal order; candidates are compared using the stamps
+		hash ^= clause.size();
+		if(hash == kEmptyHash)
+			hash++;
+		size_t mask = p_table.size() - 1;
+		size_t slot = hash & mask;
+		while(p_table[slot].hash != kEmptyHash) {
+			if(p_table[slot].hash == hash
+					&& isDuplicate(p_table[slot].handle, clause.size()))
+				return false;
+			slot = (slot + 1) & mask;
+		}
+		p_hash = hash;
+		p_slot = slot;
+		return true;
+	}
+
+	// registers the clause that was accepted by the last call to normalize()
+	void insert(uint64_t handle) {
+		if(!p_detectDuplicates)
+			return;
+		p_table[p_slot].hash = p_hash;
+		p_table[p_slot].handle = handle;
+		p_numEntries++;
+		if(2 * p_numEntries > p_table.size())
+			growTable();
+	}
+
+private:
+	static const size_t kInitialTableSize = 1024;
+	static const uint64_t kEmptyHash = 0;
+
+	struct Entry {
+		Entry() : hash(kEmptyHash), handle(0) { }
+
+		uint64_t hash;
+		// handle of the clause returned by Hooks::onClause()
+		uint64_t handle;
+	};
+
+	static size_t literalIndex(long literal) {
+		return literal < 0 ? 2 * (size_t)-literal + 1 : 2 * (size_t)literal;
+	}
+	static uint64_t mixLiteral(uint64_t index) {
+		index *= 0x9E3779B97F4A7C15ULL;
+		return index ^ (index >> 29);
+	}
+
+	void nextTimestamp() {
+		p_timestamp++;
+		if(p_timestamp == 0) {
+			std::fill(p_stamps.begin(), p_stamps.end(), 0);
+			p_timestamp = 1;
+		}
+	}
+
+	// checks if all literals of a stored clause are marked
+	bool isDuplicate(uint64_t handle, size_t length) {
+		if(p_hooks.storedLength(handle) != length)
+			return false;
+		for(size_t i = 0; i < length; i++)
+			if(p_stamps[literalIndex(p_hooks.storedLiteral(handle, i))] != p_timestamp)
+				return false;
+		return true;
+	}
+
+	void growTable() {
+		std::vector<Entry> table(2 * p_table.size());
+		size_t mask = table.size() - 1;
+		for(auto it = p_table.begin(); it != p_table.end(); ++it) {
+			if(it->hash == kEmptyHash)
+				continue;
+			size_t slot = it->hash & mask;
+			while(table[slot].hash != kEmptyHash)
+				slot = (slot + 1) & mask;
+			table[slot] = *it;
+		}
+		p_table.swap(table);
+	}
+
+	Hooks &p_hooks;
+	long p_numVars;
+
+	// timestamp of the current clause for each literal
+	std::vector<uint32_t> p_stamps;
+	uint32_t p_timestamp;
+
+	bool p_detectDuplicates;
+	// hash table of all clauses that were passed on so far
+	std::vector<Entry> p_table;
+	size_t p_numEntries;
+	// hash and free slot of the clause accepted by normalize()
+	uint64_t p_hash;
+	size_t p_slot;
+};
+
+// reads the remainder of a "p cnf" line
+// and returns the number of variables
+template<typename Hooks, typename Base>
+long parseProblemLine(Hooks &hooks, Base &base) {
+	// read the file type
+	base.skipSpace();
+	base.readWord();
+	if(!base.bufferMatch("cnf"))
+		throw std::runtime_error("Illegal cnf file");
+	
+	// read the number of vars and clauses
+	base.skipSpace();
+	base.readWord();
+	int num_vars = base.bufferGetInt();
+	
+	base.skipSpace();
+	base.readWord();
+	int num_clauses = base.bufferGetInt();
+
+	hooks.onProblem(num_vars, num_clauses);
+
+	base.skipSpace();
+	base.forceBreakOrEnd();
+	return num_vars;
+}
+
+template<typename Hooks, typename Base = BaseParser>
 class CnfParser {
 public:
-	CnfParser(Hooks &hooks, int fd) : p_hooks(hooks), p_base(fd) { }
+	CnfParser(Hooks &hooks, int fd, bool detect_duplicates)
+			: p_hooks(hooks), p_base(fd), p_normalizer(hooks, detect_duplicates) { }
 
 	void parse() {
+		bool seen_clause = false;
 		while(!p_base.atEndOfFile()) {
 			p_base.skipSpaceOrBreak();
 			if(p_base.atEndOfFile())
@@ -135,28 +483,14 @@ public:
 			if(p_base.bufferMatch("c")) {
 				p_base.skipUntilBreakOrEnd();
 			}else if(p_base.bufferMatch("p")) {
-				// read the file type
-				p_base.skipSpace();
-				p_base.readWord();
-				if(!p_base.bufferMatch("cnf"))
-					throw std::runtime_error("Illegal cnf file");
-				
-				// read the number of vars and clauses
-				p_base.skipSpace();
-				p_base.readWord();
-				int num_vars = p_base.bufferGetInt();
-				
-				p_base.skipSpace();
-				p_base.readWord();
-				int num_clauses = p_base.bufferGetInt();
-
-				p_hooks.onProblem(num_vars, num_clauses);
-
-				p_base.skipSpace();
-				p_base.forceBreakOrEnd();
+				// the problem line must precede all clauses
+				if(seen_clause)
+					throw std::runtime_error("Unexpected problem line");
+				p_normalizer.declareVariables(parseProblemLine(p_hooks, p_base));
 			}else{
 				// the line contains a clause
-				std::vector<long> lits;
+				seen_clause = true;
+				p_lits.clear();
 				while(true) {
 					int lit = p_base.bufferGetInt();
 					if(lit == 0) {
@@ -164,19 +498,186 @@ public:
 						p_base.forceBreakOrEnd();
 						break;
 					}
-					lits.push_back(lit);
+					p_lits.push_back(lit);
 					p_base.skipSpaceOrBreak();
 					p_base.readWord();
 				}
-				if(lits.size() == 0)
+				if(p_lits.size() == 0)
 					throw std::runtime_error("File contains empty clause");
 				
-				p_hooks.onClause(lits);
+				if(p_normalizer.normalize(p_lits)) {
+					p_normalizer.insert(p_hooks.onClause(p_lits));
+				}else p_hooks.onDroppedClause();
 			}
 		}
 	}
 private:
 	Hooks &p_hooks;
-	BaseParser p_base;
+	Base p_base;
+	ClauseNormalizer<Hooks> p_normalizer;
+	std::vector<long> p_lits;
 };
 
+// parses a memory mapped cnf file using multiple threads.
+// the header is read sequentially; the clause section is split into chunks
+// at line boundaries that are tokenized by worker threads. the calling thread
+// passes the clauses to the hooks in their original order
+template<typename Hooks>
+class ParallelCnfParser {
+public:
+	ParallelCnfParser(Hooks &hooks, int fd, int num_threads, bool detect_duplicates)
+			: p_hooks(hooks), p_base(fd), p_normalizer(hooks, detect_duplicates),
+			p_numThreads(num_threads) { }
+
+	void parse() {
+		// parse comments and the problem line
+		const char *clauses_begin = nullptr;
+		while(!p_base.atEndOfFile()) {
+			p_base.skipSpaceOrBreak();
+			if(p_base.atEndOfFile())
+				break;
+			const char *line = p_base.position();
+			p_base.readWord();
+			
+			if(p_base.bufferMatch("c")) {
+				p_base.skipUntilBreakOrEnd();
+			}else if(p_base.bufferMatch("p")) {
+				p_normalizer.declareVariables(parseProblemLine(p_hooks, p_base));
+			}else{
+				clauses_begin = line;
+				break;
+			}
+		}
+		if(clauses_begin == nullptr)
+			return;
+		const char *clauses_end = p_base.limit();
+
+		// split the clause section at line boundaries
+		size_t length = clauses_end - clauses_begin;
+		size_t num_chunks = std::max(std::min((size_t)p_numThreads,
+				length / kMinChunkSize), (size_t)1);
+		std::vector<Chunk> chunks(num_chunks);
+		const char *pointer = clauses_begin;
+		for(size_t i = 0; i < num_chunks; i++) {
+			const char *limit = clauses_begin + length * (i + 1) / num_chunks;
+			if(limit < pointer)
+				limit = pointer;
+			while(limit < clauses_end && *(limit - 1) != '\n')
+				limit++;
+			chunks[i].begin = pointer;
+			chunks[i].end = limit;
+			pointer = limit;
+		}
+
+		std::vector<std::thread> workers;
+		for(size_t i = 0; i < num_chunks; i++)
+			workers.emplace_back(tokenize, &chunks[i]);
+
+		// stitch the chunks together. clauses may span multiple chunks
+		std::vector<long> lits;
+		try {
+			for(size_t i = 0; i < num_chunks; i++) {
+				workers[i].join();
+				if(chunks[i].error)
+					std::rethrow_exception(chunks[i].error);
+				
+				for(auto it = chunks[i].literals.begin();
+						it != chunks[i].literals.end(); ++it) {
+					if(*it == 0) {
+						if(lits.size() == 0)
+							throw std::runtime_error("File contains empty clause");
+						if(p_normalizer.normalize(lits)) {
+							p_normalizer.insert(p_hooks.onClause(lits));
+						}else p_hooks.onDroppedClause();
+						lits.clear();
+					}else lits.push_back(*it);
+				}
+				std::vector<int>().swap(chunks[i].literals);
+			}
+		}catch(...) {
+			// the hooks may throw, too. join the remaining workers first
+			for(auto it = workers.begin(); it != workers.end(); ++it)
+				if(it->joinable())
+					it->join();
+			throw;
+		}
+		if(lits.size() != 0)
+			throw std::runtime_error("Clause is not terminated");
+	}
+
+private:
+	static const size_t kMinChunkSize = 1024 * 1024;
+
+	struct Chunk {
+		const char *begin;
+		const char *end;
+		// literals of all clauses in this chunk; clauses are terminated by zero
+		std::vector<int> literals;
+		std::exception_ptr error;
+	};
+
+	static void tokenize(Chunk *chunk) {
+		try {
+			MappedParser base(chunk->begin, chunk->end);
+			while(!base.atEndOfFile()) {
+				base.skipSpaceOrBreak();
+				if(base.atEndOfFile())
+					break;
+				base.readWord();
+				
+				if(base.bufferMatch("c")) {
+					base.skipUntilBreakOrEnd();
+				}else if(base.bufferMatch("p")) {
+					throw std::runtime_error("Unexpected problem line");
+				}else{
+					int lit = base.bufferGetInt();
+					chunk->literals.push_back(lit);
+					if(lit == 0) {
+						base.skipSpace();
+						base.forceBreakOrEnd();
+					}
+				}
+			}
+		}catch(...) {
+			chunk->error = std::current_exception();
+		}
+	}
+
+	Hooks &p_hooks;
+	MappedParser p_base;
+	ClauseNormalizer<Hooks> p_normalizer;
+	int p_numThreads;
+};
+
+// parses the cnf file referred to by fd.
+// uncompressed regular files are mapped into memory while pipes
+// and compressed files are read()
+template<typename Hooks>
+void parseCnf(Hooks &hooks, int fd, int num_threads = 1, bool detect_duplicates = true) {
+	struct stat st;
+	if(fstat(fd, &st) != 0)
+		throw std::runtime_error("Could not stat input");
+	
+	if(S_ISREG(st.st_mode)) {
+		char magic[sys::kCompressMagicLength];
+		ssize_t len = pread(fd, magic, sys::kCompressMagicLength, 0);
+		if(len == -1)
+			throw std::runtime_error("Could not read input");
+		if(sys::detectCompression(magic, len) != sys::kCompressNone) {
+			CnfParser<Hooks> reader(hooks, fd, detect_duplicates);
+			reader.parse();
+			return;
+		}
+	}
+	
+	if(S_ISREG(st.st_mode) && num_threads > 1) {
+		ParallelCnfParser<Hooks> reader(hooks, fd, num_threads, detect_duplicates);
+		reader.parse();
+	}else if(S_ISREG(st.st_mode)) {
+		CnfParser<Hooks, MappedParser> reader(hooks, fd, detect_duplicates);
+		reader.parse();
+	}else{
+		CnfParser<Hooks> reader(hooks, fd, detect_duplicates);
+		reader.parse();
+	}
+}
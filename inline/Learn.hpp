@@ -4,6 +4,7 @@ namespace satuzk {
 struct VarInfo {
 	static const uint8_t kFlagTouched = 1;
 	static const uint8_t kFlagMarked = 2;
+	static const uint8_t kFlagHinted = 4;
 	static const uint8_t kFlagMinChecked = 16;
 	static const uint8_t kFlagMinImplied = 32;
 	static const uint8_t kFlagVarInCut = 64;
@@ -110,6 +111,14 @@ public:
 
 	template<typename Hooks>
 	__attribute__((always_inline)) inline void build(Hooks &hooks);
+
+	// collects the ids of the antecedents that derive the minimized clause
+	// from the conflict in an order that is suitable for lrat proofs
+	template<typename Hooks>
+	void collectHints(Hooks &hooks,
+			typename Hooks::ConflictIterator begin,
+			typename Hooks::ConflictIterator end,
+			std::vector<uint64_t> &hints);
 };
 
 template<typename BaseDefs>
@@ -356,5 +365,49 @@ void LearnConfigStruct<BaseDefs>::build(Hooks &hooks) {
 	}
 }
 
+template<typename BaseDefs>
+template<typename Hooks>
+void LearnConfigStruct<BaseDefs>::collectHints(Hooks &hooks,
+		typename Hooks::ConflictIterator begin,
+		typename Hooks::ConflictIterator end,
+		std::vector<uint64_t> &hints) {
+	// depth-first search over the implication graph. the antecedent of
+	// a variable is emitted after the antecedents of all its causes
+	struct Item {
+		typename Hooks::Variable var;
+		bool expanded;
+	};
+	std::vector<Item> stack;
+	for(auto i = begin; i != end; ++i)
+		stack.push_back(Item{(*i).variable(), false});
+	
+	while(!stack.empty()) {
+		Item item = stack.back();
+		stack.pop_back();
+		if(item.expanded) {
+			hints.push_back(hooks.antecedentId(item.var));
+			continue;
+		}
+
+		// literals of the minimized clause are false by assumption
+		VarInfo &var_info = p_varInfos[item.var.getIndex()];
+		if((var_info.flags & (VarInfo::kFlagVarInMin | VarInfo::kFlagHinted)) != 0)
+			continue;
+		if((var_info.flags & VarInfo::kFlagTouched) == 0) {
+			p_touchedVars.push_back(item.var);
+			var_info.flags |= VarInfo::kFlagTouched;
+		}
+		var_info.flags |= VarInfo::kFlagHinted;
+
+		stack.push_back(Item{item.var, true});
+		// decisions that are not part of the clause are units
+		auto antecedent = hooks.varAntecedent(item.var);
+		if(antecedent.isDecision())
+			continue;
+		for(auto i = hooks.causesBegin(antecedent); i != hooks.causesEnd(antecedent); ++i)
+			stack.push_back(Item{(*i).variable(), false});
+	}
+}
+
 }; // namespace satuzk
 
@@ -0,0 +1,145 @@
+
+namespace satuzk {
+
+// assignment of the variables 1 to numVariables.
+// bit (i - 1) of the bitset is set if variable i is true
+struct PackedModel {
+	uint64_t numVariables;
+	std::vector<uint64_t> words;
+	// bit (i - 1) is set if variable i is not assigned by the model.
+	// empty if all variables are assigned
+	std::vector<uint64_t> freeWords;
+
+	PackedModel() : numVariables(0) { }
+
+	void resize(uint64_t num_vars) {
+		numVariables = num_vars;
+		words.assign((num_vars + 63) / 64, 0);
+		freeWords.clear();
+	}
+	void setTrue(uint64_t var_num) {
+		words[(var_num - 1) / 64] |= uint64_t(1) << ((var_num - 1) % 64);
+	}
+	bool isTrue(uint64_t var_num) const {
+		return (words[(var_num - 1) / 64] >> ((var_num - 1) % 64)) & 1;
+	}
+	void setFree(uint64_t var_num) {
+		if(freeWords.empty())
+			freeWords.assign(words.size(), 0);
+		freeWords[(var_num - 1) / 64] |= uint64_t(1) << ((var_num - 1) % 64);
+	}
+	bool hasFree() const {
+		return !freeWords.empty();
+	}
+};
+
+/* binary model files consist of the header followed by the words
+ * of the packed model. the words are only present for satisfiable instances */
+struct BinaryModelHeader {
+	static const uint32_t kVersion = 1;
+
+	char magic[8];
+	uint32_t version;
+	// 10 for satisfiable, 20 for unsatisfiable and 0 otherwise
+	uint32_t status;
+	uint64_t numVariables;
+};
+
+static const char kBinaryModelMagic[8] = { 's', 'a', 't', 'U', 'Z', 'K', 'm', 'd' };
+
+// formats models into a large buffer that is written to the stream in bulk
+class ModelWriter {
+public:
+	ModelWriter(std::ostream &stream) : p_stream(stream) {
+		p_buffer.reserve(kBufferSize + kBufferSlack);
+	}
+	~ModelWriter() {
+		flush();
+	}
+	ModelWriter(const ModelWriter &other) = delete;
+	ModelWriter &operator= (const ModelWriter &other) = delete;
+
+	void writeString(const char *string) {
+		p_buffer.insert(p_buffer.end(), string, string + std::strlen(string));
+	}
+
+	// writes "l1 l2 ... ln " where li is either i or -i.
+	// free variables are written as false unless skip_free is set
+	void writeLiterals(const PackedModel &model, bool skip_free = false) {
+		// variables are written in increasing order. instead of converting
+		// each number we increment its decimal representation in place
+		char digits[24];
+		char *digits_end = digits + sizeof(digits);
+		char *digits_begin = digits_end - 1;
+		*digits_begin = '1';
+
+		for(uint64_t k = 0; k < model.words.size(); k++) {
+			uint64_t word = model.words[k];
+			uint64_t skip = skip_free && model.hasFree() ? model.freeWords[k] : 0;
+			uint64_t count = std::min(uint64_t(64), model.numVariables - 64 * k);
+			for(uint64_t j = 0; j < count; j++) {
+				if(!((skip >> j) & 1)) {
+					if(!((word >> j) & 1))
+						p_buffer.push_back('-');
+					p_buffer.insert(p_buffer.end(), digits_begin, digits_end);
+					p_buffer.push_back(' ');
+				}
+
+				char *digit = digits_end - 1;
+				while(digit >= digits_begin && *digit == '9') {
+					*digit = '0';
+					--digit;
+				}
+				if(digit < digits_begin) {
+					--digits_begin;
+					*digits_begin = '1';
+				}else ++(*digit);
+			}
+			if(p_buffer.size() >= kBufferSize)
+				flush();
+		}
+	}
+
+	// writes the model as a single v line
+	void writeVLine(const PackedModel &model, bool skip_free = false) {
+		writeString("v ");
+		writeLiterals(model, skip_free);
+		writeString("0\n");
+	}
+
+	void flush() {
+		p_stream.write(p_buffer.data(), p_buffer.size());
+		p_buffer.clear();
+	}
+
+private:
+	static const size_t kBufferSize = 1024 * 1024;
+	// enough space for a full word of literals
+	static const size_t kBufferSlack = 64 * 24;
+
+	std::ostream &p_stream;
+	std::vector<char> p_buffer;
+};
+
+// writes a binary model file. the model is ignored unless status is 10
+inline void writeBinaryModel(const std::string &file_name,
+		uint32_t status, const PackedModel &model) {
+	BinaryModelHeader header;
+	std::memcpy(header.magic, kBinaryModelMagic, sizeof(kBinaryModelMagic));
+	header.version = BinaryModelHeader::kVersion;
+	header.status = status;
+	header.numVariables = status == 10 ? model.numVariables : 0;
+
+	std::ofstream stream(file_name, std::ofstream::out
+			| std::ofstream::trunc | std::ofstream::binary);
+	stream.write((const char*)&header, sizeof(BinaryModelHeader));
+	if(status == 10)
+		stream.write((const char*)model.words.data(),
+				model.words.size() * sizeof(uint64_t));
+	stream.close();
+	if(stream.fail())
+		throw std::runtime_error("Could not write binary model");
+}
+
+}; // namespace satuzk
+
@@ -13,7 +13,7 @@ public:
 		Order firstIndex;
 	};
 
-	PropagateConfigStruct() : p_propagatePointer(0) { }
+	PropagateConfigStruct() : p_propagatePointer(0), p_binaryPointer(0) { }
 
 	Declevel curDeclevel() {
 		return p_decisions.size();
@@ -29,6 +29,7 @@ public:
 	void newDecision() {
 		// PRE-CONDITION: no assignments have been pushed but not propagated yet
 		SYS_ASSERT(SYS_ASRT_GENERAL, !propagatePending());
+		SYS_ASSERT(SYS_ASRT_GENERAL, !binaryPending());
 
 		DecisionInfo decision;
 		decision.firstIndex = p_assigns.size();
@@ -43,6 +44,7 @@ public:
 		DecisionInfo info = p_decisions.back();
 		SYS_ASSERT(SYS_ASRT_GENERAL, info.firstIndex == p_assigns.size());
 		SYS_ASSERT(SYS_ASRT_GENERAL, info.firstIndex == p_propagatePointer);
+		SYS_ASSERT(SYS_ASRT_GENERAL, info.firstIndex == p_binaryPointer);
 		
 		p_decisions.pop_back();
 		return info;
@@ -61,7 +63,7 @@ public:
 		/* PRE-CONDITION: the top-most literal on the assign stack
 				is from the current decision level */
 		DecisionInfo info = p_decisions.back();
-		SYS_ASSERT(SYS_ASRT_GENERAL, p_assigns.size() > p_propagatePointer);
+		SYS_ASSERT(SYS_ASRT_GENERAL, p_assigns.size() > p_binaryPointer);
 		SYS_ASSERT(SYS_ASRT_GENERAL, p_assigns.size() > info.firstIndex);
 		
 		Literal literal = p_assigns.back();
@@ -88,6 +90,7 @@ public:
 	void propagateReset() {
 		DecisionInfo info = p_decisions.back();
 		p_propagatePointer = info.firstIndex;
+		p_binaryPointer = info.firstIndex;
 	}
 	bool propagatePending() {
 		return p_propagatePointer != p_assigns.size();
@@ -98,50 +101,106 @@ public:
 		return literal;
 	}
 
+	/* binary implications are propagated ahead of the other clauses.
+	 * all assignments before the binary pointer have already been
+	 * propagated through their binary implication lists */
+	bool binaryPending() {
+		return p_binaryPointer != p_assigns.size();
+	}
+	Literal nextBinary() {
+		Literal literal = p_assigns[p_binaryPointer];
+		p_binaryPointer++;
+		return literal;
+	}
+
 private:
 	std::vector<Literal> p_assigns;
 	std::vector<DecisionInfo> p_decisions;
 	Order p_propagatePointer;
+	Order p_binaryPointer;
 };
 
+template<typename Hooks, typename Callback>
+__attribute__((always_inline)) inline bool propagateBinary(Hooks &hooks, Callback &callback,
+		typename Hooks::Literal literal) {
+	auto end = hooks.binaryEnd(literal);
+	for(auto it = hooks.binaryBegin(literal); it != end; ++it) {
+		// if the literal is already true there is nothing to do
+		typename Hooks::Literal implied = (*it).binaryGetImplied();
+		SYS_ASSERT(SYS_ASRT_GENERAL, hooks.varIsPresent(implied.variable()));
+		if(hooks.litTrue(implied))
+			continue;
+
+		// otherwise there might be a conflict
+		if(hooks.litFalse(implied)) {
+			SYS_ASSERT(SYS_ASRT_GENERAL, hooks.varDeclevel(implied.variable())
+					== hooks.curDeclevel());
+			hooks.raiseConflict(Hooks::Conflict::makeBinary(literal, implied.inverse()));
+			return true;
+		}
+
+		hooks.pushAssign(implied, Hooks::Antecedent::makeBinary(literal));
+		callback.onUnit(implied);
+	}
+	return false;
+}
+
+#ifdef FEATURE_WATCH_PREFETCH
+#ifndef WATCH_PREFETCH_DISTANCE
+#define WATCH_PREFETCH_DISTANCE 2
+#endif
+// number of watch list entries whose clauses are prefetched in advance.
+// bench.sh measures distances of 2 to 16; 2 was the fastest one
+static const int kWatchPrefetchDistance = WATCH_PREFETCH_DISTANCE;
+#endif
+
 template<typename Hooks, typename Callback>
 __attribute__((always_inline)) inline bool propagateWatch(Hooks &hooks, Callback &callback,
 		typename Hooks::Literal literal) {
 	auto begin = hooks.watchBegin(literal);
 	auto end = hooks.watchEnd(literal);
 	auto wp = begin;
+#ifdef FEATURE_WATCH_PREFETCH
+	auto ahead = begin;
+#endif
 	for(auto rp = begin; rp != end; ++rp) {
-		if((*rp).isBinary()) {
-			// if the literal is already true there is nothing to do
-			typename Hooks::Literal implied = (*rp).binaryGetImplied();
-			SYS_ASSERT(SYS_ASRT_GENERAL, hooks.varIsPresent(implied.variable()));
-			if(hooks.litTrue(implied)) {
-				*wp = *rp;
-				++wp;
+#ifdef FEATURE_WATCH_PREFETCH
+		/* request the clauses of the next long entries before they are needed.
+		 * clauses whose blocking literal is true are not going to be accessed */
+		while(ahead != end && ahead - rp < kWatchPrefetchDistance) {
+			if((*ahead).isLong() && !hooks.litTrue((*ahead).longGetBlocking()))
+				hooks.clausePrefetch((*ahead).longGetClause());
+			++ahead;
+		}
+#endif
+		if((*rp).isTernary()) {
+			// ternary clauses are watched on all literals and never move
+			*wp = *rp;
+			++wp;
+			typename Hooks::Literal first = (*rp).ternaryGetFirst();
+			typename Hooks::Literal second = (*rp).ternaryGetSecond();
+			if(hooks.litTrue(first) || hooks.litTrue(second))
 				continue;
-			}
 
-			// otherwise there might be a conflict
-			if(hooks.litFalse(implied)) {
-				auto var = implied.variable();
-				auto declevel = hooks.varDeclevel(var);
-				SYS_ASSERT(SYS_ASRT_GENERAL, declevel == hooks.curDeclevel());
-				hooks.raiseConflict(Hooks::Conflict::makeBinary(literal, implied.inverse()));
+			if(hooks.litFalse(first) && hooks.litFalse(second)) {
+				hooks.raiseConflict(Hooks::Conflict::makeTernary(literal,
+						first.inverse(), second.inverse()));
 				
 				// copy the remaining watch list
+				++rp;
 				while(rp != end) {
 					*wp = *rp;
 					++rp; ++wp;
 				}
 				hooks.watchCut(literal, wp);
 				return true;
+			}else if(hooks.litFalse(first)) {
+				hooks.pushAssign(second, Hooks::Antecedent::makeTernary(literal, first.inverse()));
+				callback.onUnit(second);
+			}else if(hooks.litFalse(second)) {
+				hooks.pushAssign(first, Hooks::Antecedent::makeTernary(literal, second.inverse()));
+				callback.onUnit(first);
 			}
-			
-			hooks.pushAssign(implied, Hooks::Antecedent::makeBinary(literal));
-			callback.onUnit(implied);
-			
-			*wp = *rp;
-			++wp;
 			continue;
 		}
 		
@@ -166,12 +225,11 @@ __attribute__((always_inline)) inline bool propagateWatch(Hooks &hooks, Callback
 		if(current1 == trigger) {
 			current1 = current2;
 			current2 = trigger;
+			hooks.clauseSwapWatched(clause);
 		}
-		hooks.clauseSetFirst(clause, current1);
 		
 		// case 1: a watched literal is true
 		if(hooks.litTrue(current1)) {
-			hooks.clauseSetSecond(clause, current2);
 			(*wp).setLong();
 			(*wp).longSetClause(clause);
 			(*wp).longSetBlocking(current1);
@@ -181,22 +239,18 @@ __attribute__((always_inline)) inline bool propagateWatch(Hooks &hooks, Callback
 		auto var = current1.variable();	
 		
 		// try to find an unassigned literal. write that literal to index #2
-		for(auto it = hooks.clauseBegin3(clause);
-				it != hooks.clauseEnd(clause); ++it) {
-			typename Hooks::Literal lit = *it;
-			if(!hooks.litFalse(lit)) {
-				// case 2: the are is a unassigned literal
-				hooks.clauseSetSecond(clause, lit);
-				*it = current2;
-			
-				// the propagated literal is no longer watched 
-				hooks.watchInsertClause(lit.inverse(), current1, clause);
-				goto next_clause;
-			}
-		} 
+		typename Hooks::Literal *replacement = hooks.clauseFindWatch(clause);
+		if(replacement != NULL) {
+			// case 2: the are is a unassigned literal
+			typename Hooks::Literal lit = *replacement;
+			hooks.clauseWatchSecond(clause, replacement);
+		
+			// the propagated literal is no longer watched 
+			hooks.watchInsertClause(lit.inverse(), current1, clause);
+			continue;
+		}
 			
 		// the propagated literal is still watched
-		hooks.clauseSetSecond(clause, current2);
 		(*wp).setLong();
 		(*wp).longSetClause(clause);
 		(*wp).longSetBlocking(current1);
@@ -227,7 +281,6 @@ __attribute__((always_inline)) inline bool propagateWatch(Hooks &hooks, Callback
 				hooks.clauseSetLbd(clause, new_lbd);
 			}
 		}
-		next_clause:;
 	}
 	hooks.watchCut(literal, wp);
 	return false;
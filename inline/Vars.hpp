@@ -10,17 +10,12 @@ void WatchlistEntryStruct<BaseDefs>::setLong() {
 	field1 &= ~kFlagMask;
 }
 template<typename BaseDefs>
-void WatchlistEntryStruct<BaseDefs>::setBinary() {
-	field1 &= ~kFlagMask;
-	field1 |= kFlagBinary;
-}
-template<typename BaseDefs>
 bool WatchlistEntryStruct<BaseDefs>::isLong() {
 	return (field1 & kFlagMask) == kFlagLong;
 }
 template<typename BaseDefs>
-bool WatchlistEntryStruct<BaseDefs>::isBinary() {
-	return (field1 & kFlagMask) == kFlagBinary;
+bool WatchlistEntryStruct<BaseDefs>::isTernary() {
+	return (field1 & kFlagMask) == kFlagTernary;
 }
 
 template<typename BaseDefs>
@@ -29,8 +24,7 @@ void WatchlistEntryStruct<BaseDefs>::binarySetImplied(Literal literal) {
 }
 template<typename BaseDefs>
 void WatchlistEntryStruct<BaseDefs>::binarySetClause(Clause clause) {
-	SYS_ASSERT(SYS_ASRT_GENERAL, !(clause.getIndex() & kFlagMask));
-	field1 = clause.getIndex() | kFlagBinary;
+	field1 = clause.getIndex();
 }
 template<typename BaseDefs>
 typename WatchlistEntryStruct<BaseDefs>::Literal WatchlistEntryStruct<BaseDefs>::binaryGetImplied() {
@@ -38,7 +32,7 @@ typename WatchlistEntryStruct<BaseDefs>::Literal WatchlistEntryStruct<BaseDefs>:
 }
 template<typename BaseDefs>
 typename WatchlistEntryStruct<BaseDefs>::Clause WatchlistEntryStruct<BaseDefs>::binaryGetClause() {
-	return Clause::fromIndex(field1 & ~kFlagMask);
+	return Clause::fromIndex(field1);
 }
 
 template<typename BaseDefs>
@@ -59,10 +53,58 @@ typename WatchlistEntryStruct<BaseDefs>::Literal WatchlistEntryStruct<BaseDefs>:
 	return Literal::fromIndex(field2);
 }
 
+template<typename BaseDefs>
+void WatchlistEntryStruct<BaseDefs>::ternarySetLiterals(Literal first, Literal second) {
+	SYS_ASSERT(SYS_ASRT_GENERAL, ternaryFits(first));
+	field1 = first.getIndex() | kFlagTernary;
+	field2 = second.getIndex();
+}
+template<typename BaseDefs>
+typename WatchlistEntryStruct<BaseDefs>::Literal WatchlistEntryStruct<BaseDefs>::ternaryGetFirst() {
+	return Literal::fromIndex(field1 & ~kFlagMask);
+}
+template<typename BaseDefs>
+typename WatchlistEntryStruct<BaseDefs>::Literal WatchlistEntryStruct<BaseDefs>::ternaryGetSecond() {
+	return Literal::fromIndex(field2);
+}
+
 // -----------------------------------------------------------------
 // VarConfigStruct class
 // -----------------------------------------------------------------
 
+/* if AVX2 is available the assignments of eight literals are gathered
+ * at once. the assignment of a variable is a single byte: the gather loads
+ * four bytes starting at that byte and the upper three bytes are ignored */
+template<typename BaseDefs>
+typename VarConfigStruct<BaseDefs>::Literal *VarConfigStruct<BaseDefs>::litFindNotFalse(
+		Literal *begin, Literal *end) {
+	static_assert(sizeof(AssignInfo) == 1, "assignments must be single bytes");
+	static_assert(sizeof(Literal) == 4, "literals must be 32-bit indices");
+
+	Literal *it = begin;
+#ifdef __AVX2__
+	const int *base = (const int*)p_assigns.data();
+	const __m256i one = _mm256_set1_epi32(1);
+	for(; end - it >= 8; it += 8) {
+		__m256i literals = _mm256_loadu_si256((const __m256i*)it);
+		__m256i values = _mm256_i32gather_epi32(base,
+				_mm256_srli_epi32(literals, 1), 1);
+		// a literal is false if it is assigned (bit 1 of its value)
+		// and the value and the literal differ in bit 0
+		__m256i is_false = _mm256_and_si256(_mm256_srli_epi32(values, 1),
+				_mm256_xor_si256(values, literals));
+		is_false = _mm256_cmpeq_epi32(_mm256_and_si256(is_false, one), one);
+		int not_false = ~_mm256_movemask_ps(_mm256_castsi256_ps(is_false)) & 0xFF;
+		if(not_false)
+			return it + __builtin_ctz(not_false);
+	}
+#endif
+	for(; it != end; ++it)
+		if(!litIsFalse(*it))
+			return it;
+	return end;
+}
+
 template<typename BaseDefs>
 void VarConfigStruct<BaseDefs>::occurPrepare() {
 	p_occlists.resize(p_assigns.size() * 2);
@@ -71,11 +113,12 @@ void VarConfigStruct<BaseDefs>::occurPrepare() {
 template<typename BaseDefs>
 void VarConfigStruct<BaseDefs>::occurFinish() {
 	p_occlists.clear();
+	p_occurPool.reset();
 }
 
 template<typename BaseDefs>
 void VarConfigStruct<BaseDefs>::occurInsert(Literal literal, Clause clause) {
-	p_occlists[literal.getIndex()].insert(clause);
+	p_occlists[literal.getIndex()].insert(p_occurPool, clause);
 }
 template<typename BaseDefs>
 void VarConfigStruct<BaseDefs>::occurRemove(Literal literal, Clause clause) {
@@ -85,5 +128,50 @@ void VarConfigStruct<BaseDefs>::occurRemove(Literal literal, Clause clause) {
 	p_occlists[literal.getIndex()].erase(it);
 }
 
+// orders literal indices by decreasing number of watch list traversals
+template<typename Index>
+class WatchVisitsGt {
+public:
+	WatchVisitsGt(const std::vector<uint32_t> &visits) : p_visits(visits) { }
+
+	bool operator() (Index a, Index b) {
+		return p_visits[a] > p_visits[b];
+	}
+
+private:
+	const std::vector<uint32_t> &p_visits;
+};
+
+// returns the literal indices by decreasing number of watch list traversals
+template<typename BaseDefs>
+void VarConfigStruct<BaseDefs>::watchHotOrder(std::vector<Index> &order) {
+	order.clear();
+	order.reserve(p_watchlists.size());
+	for(Index i = 0; i < p_watchlists.size(); i++)
+		order.push_back(i);
+	WatchVisitsGt<Index> comparator(p_watchVisits);
+	std::stable_sort(order.begin(), order.end(), comparator);
+}
+
+/* moves all watch lists to fresh slabs. the lists that were traversed most
+ * often since the last compaction are placed first so that the lists
+ * that are needed during propagation are close to each other in memory */
+template<typename BaseDefs>
+void VarConfigStruct<BaseDefs>::watchCompact() {
+	std::vector<Index> order;
+	watchHotOrder(order);
+
+	p_watchPool.beginCompaction();
+	for(auto it = order.begin(); it != order.end(); ++it) {
+		p_binlists[*it].compact(p_watchPool);
+		p_watchlists[*it].compact(p_watchPool);
+	}
+	p_watchPool.endCompaction();
+
+	// older traversals become less important
+	for(auto it = p_watchVisits.begin(); it != p_watchVisits.end(); ++it)
+		*it /= 2;
+}
+
 }; // namespace satuzk
 
@@ -9,61 +9,82 @@ int Master::run() {
 	p_reducers[0]->linkSolver(*p_solvers[0]);
 	p_reducers[0]->linkSolver(*p_solvers[1]);
 
+	if(opts.memLimit != 0) {
+		uint64_t share = opts.memLimit / (p_solvers.size() + p_reducers.size());
+		for(auto it = p_solvers.begin(); it != p_solvers.end(); ++it)
+			(*it)->limitMemory(share);
+		for(auto it = p_reducers.begin(); it != p_reducers.end(); ++it)
+			(*it)->limitMemory(share);
+	}
+
 	for(auto it = p_solvers.begin(); it != p_solvers.end(); ++it)
 		p_threads.emplace_back(std::bind(&SolverThread::run, *it));
 	for(auto it = p_reducers.begin(); it != p_reducers.end(); ++it)
 		p_threads.emplace_back(std::bind(&ReducerThread::run, *it));
 
-	int instance_fd = open(p_instance.c_str(), O_RDONLY);
-	if(instance_fd == -1)
-		throw std::runtime_error("Could not open instance file");
+	if(opts.parseOnce)
+		p_parsedClauses = new ParsedClauses;
+
+	// "-" reads the instance from stdin
+	int instance_fd = 0;
+	if(p_instance != "-") {
+		instance_fd = open(p_instance.c_str(), O_RDONLY);
+		if(instance_fd == -1)
+			throw std::runtime_error("Could not open instance file");
+	}
 	
 	CnfReadHooks read_hooks(*this);
-	CnfParser<CnfReadHooks> reader(read_hooks, instance_fd);
-	reader.parse();
+	bool input_aborted = false;
+	try {
+		// duplicates are detected in the parsed clauses. when the clauses
+		// are streamed to the threads the master does not keep them
+		parseCnf(read_hooks, instance_fd, opts.parseThreads,
+				opts.detectDuplicates && p_parsedClauses != nullptr);
+	}catch(InputAborted &e) {
+		input_aborted = true;
+	}
 	
-	if(close(instance_fd) != 0)
+	if(instance_fd != 0 && close(instance_fd) != 0)
 		throw std::runtime_error("Could not close instance file");
 
-	std::cout << "Finished parsing" << std::endl;
+	if(input_aborted) {
+		std::cout << "c parsing aborted" << std::endl;
+	}else{
+		std::cout << "Finished parsing" << std::endl;
+
+		if(p_parsedClauses != nullptr) {
+			p_parsedClauses->pendingThreads = p_solvers.size() + p_reducers.size();
+			for(auto bc = p_solvers.begin(); bc != p_solvers.end(); ++bc) {
+				(*bc)->writeCommand(SolverThread::CommandTag::kParsedClauses);
+				(*bc)->writeCommand(p_parsedClauses);
+				(*bc)->sendCommand();
+			}
+			for(auto bc = p_reducers.begin(); bc != p_reducers.end(); ++bc) {
+				(*bc)->writeCommand(ReducerThread::CommandTag::kParsedClauses);
+				(*bc)->writeCommand(p_parsedClauses);
+				(*bc)->sendCommand();
+			}
+		}
 
-	for(auto bc = p_solvers.begin(); bc != p_solvers.end(); ++bc) {
-		(*bc)->writeCommand(SolverThread::CommandTag::kInitialize);
-		(*bc)->sendCommand();
-		
-		(*bc)->writeCommand(SolverThread::CommandTag::kContinue);
-		(*bc)->sendCommand();
+		// solvers do not report models before they received all clauses
+		for(auto bc = p_solvers.begin(); bc != p_solvers.end(); ++bc) {
+			(*bc)->writeCommand(SolverThread::CommandTag::kInputDone);
+			(*bc)->sendCommand();
+		}
+		if(!p_solversStarted)
+			startSolvers();
 	}
 
-	int exit_code = 0;
-
 	while(!globalExitFlag) {
-		for(auto it = p_solvers.begin(); it != p_solvers.end(); ++it) {
-			if((*it)->recvMessage()) {
-				auto tag = (*it)->readMessage<SolverThread::MessageTag>();
-				if(tag == SolverThread::MessageTag::kSolvedSat) {
-					std::cout << "s SATISFIABLE" << std::endl;
-
-					int num_vars = (*it)->readMessage<int>();
-					for(int i = 0; i < num_vars; i++) {
-						bool is_one = (*it)->readMessage<bool>();
-						int literal_num = is_one ? (i + 1) : -(i + 1);
-						p_model.push_back(literal_num);
-					}
-
-					globalExitFlag = true;
-					exit_code = 10;
-					break;
-				}else if(tag == SolverThread::MessageTag::kSolvedUnsat) {
-					std::cout << "s UNSATISFIABLE" << std::endl;
-					globalExitFlag = true;
-					exit_code = 20;
-					break;
-				}else SYS_CRITICAL("Illegal solver message");
-			}
-		}
-		if(!globalExitFlag)
-			std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		/* the threads refer to the literals until they exit but
+		 * the offsets are not needed once all threads loaded the clauses */
+		if(p_parsedClauses != nullptr && p_parsedClauses->pendingThreads == 0
+				&& !p_parsedClauses->offsets.empty())
+			std::vector<uint64_t>().swap(p_parsedClauses->offsets);
+
+		if(checkSolvers())
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
 	}
 
 	for(auto bc = p_solvers.begin(); bc != p_solvers.end(); ++bc) {
@@ -77,23 +98,61 @@ int Master::run() {
 	
 	for(auto it = p_threads.begin(); it != p_threads.end(); ++it)
 		(*it).join();
+	delete p_parsedClauses;
+	p_parsedClauses = nullptr;
 	
 	for(auto it = p_solvers.begin(); it != p_solvers.end(); ++it)
 		std::cout << "c (" << (*it)->getConfigId() << " ) exported: "
-			<< (*it)->stat.exported << ", imported: " << (*it)->stat.imported << std::endl;
+			<< (*it)->stat.exported << ", imported: " << (*it)->stat.imported
+			<< ", dropped: " << (*it)->stat.dropped << std::endl;
 
 	for(auto it = p_solvers.begin(); it != p_solvers.end(); ++it)
 		delete *it;
 	for(auto it = p_reducers.begin(); it != p_reducers.end(); ++it)
 		delete *it;
-	return exit_code;
+	return p_exitCode;
 }
 
-std::vector<int>::iterator Master::beginModel() {
-	return p_model.begin();
+void Master::startSolvers() {
+	for(auto bc = p_solvers.begin(); bc != p_solvers.end(); ++bc) {
+		(*bc)->writeCommand(SolverThread::CommandTag::kInitialize);
+		(*bc)->sendCommand();
+		
+		(*bc)->writeCommand(SolverThread::CommandTag::kContinue);
+		(*bc)->sendCommand();
+	}
+	p_solversStarted = true;
 }
-std::vector<int>::iterator Master::endModel() {
-	return p_model.end();
+
+// processes messages from the solver threads.
+// returns true if the instance was solved
+bool Master::checkSolvers() {
+	for(auto it = p_solvers.begin(); it != p_solvers.end(); ++it) {
+		if(!(*it)->recvMessage())
+			continue;
+		auto tag = (*it)->readMessage<SolverThread::MessageTag>();
+		if(tag == SolverThread::MessageTag::kSolvedSat) {
+			std::cout << "s SATISFIABLE" << std::endl;
+
+			p_model.resize((*it)->readMessage<uint64_t>());
+			for(auto word = p_model.words.begin(); word != p_model.words.end(); ++word)
+				*word = (*it)->readMessage<uint64_t>();
+
+			globalExitFlag = true;
+			p_exitCode = 10;
+			return true;
+		}else if(tag == SolverThread::MessageTag::kSolvedUnsat) {
+			std::cout << "s UNSATISFIABLE" << std::endl;
+			globalExitFlag = true;
+			p_exitCode = 20;
+			return true;
+		}else SYS_CRITICAL("Illegal solver message");
+	}
+	return false;
+}
+
+const satuzk::PackedModel &Master::getModel() {
+	return p_model;
 }
 
 void Master::CnfReadHooks::onProblem(long num_vars, long num_clauses) {
@@ -110,28 +169,18 @@ void Master::CnfReadHooks::onProblem(long num_vars, long num_clauses) {
 		(*bc)->writeCommand<long>(num_vars);
 		(*bc)->sendCommand();
 	}
+
+	if(p_master.opts.onlineInput)
+		p_master.startSolvers();
 }
 
-void Master::CnfReadHooks::onClause(std::vector<long> &in_clause) {
-	// remove duplicates and check for tautologies
-	// TODO: move this to the cnf reader
-	auto k = in_clause.begin();
-	for(auto i = in_clause.begin(); i != in_clause.end(); ++i) {
-		bool duplicate = false;
-		for(auto j = i + 1; j != in_clause.end(); ++j) {
-			if(*j == *i) {
-				duplicate = true;
-			}else if(*j == -*i) {
-				return;
-			}
-		}
-		if(duplicate)
-			continue;
-		*k = *i;
-		k++;
-	}
-	in_clause.resize(k - in_clause.begin());
-	
+uint64_t Master::CnfReadHooks::onClause(std::vector<long> &in_clause) {
+	// stop parsing if a prefix of the instance is already unsatisfiable
+	p_clauseCount++;
+	if(p_master.opts.onlineInput && p_clauseCount % kPollInterval == 0
+			&& (globalExitFlag || p_master.checkSolvers()))
+		throw InputAborted();
+
 	// transform input variable ids to internal variable ids
 	std::vector<BaseDefs::LiteralIndex> out_clause;
 	for(auto it = in_clause.begin(); it != in_clause.end(); ++it) {
@@ -144,6 +193,14 @@ void Master::CnfReadHooks::onClause(std::vector<long> &in_clause) {
 		out_clause.push_back(intern_literal);
 	}
 	
+	if(p_master.p_parsedClauses != nullptr) {
+		ParsedClauses *parsed = p_master.p_parsedClauses;
+		parsed->literals.insert(parsed->literals.end(),
+				out_clause.begin(), out_clause.end());
+		parsed->offsets.push_back(parsed->literals.size());
+		return parsed->numClauses() - 1;
+	}
+
 	for(auto bc = p_master.p_solvers.begin(); bc != p_master.p_solvers.end(); ++bc) {
 		(*bc)->writeCommand(SolverThread::CommandTag::kClause);
 		(*bc)->writeCommand<int>(out_clause.size());
@@ -159,5 +216,18 @@ void Master::CnfReadHooks::onClause(std::vector<long> &in_clause) {
 			(*bc)->writeCommand<BaseDefs::LiteralIndex>(*cp);
 		(*bc)->sendCommand();
 	}
+	return 0;
+}
+
+size_t Master::CnfReadHooks::storedLength(uint64_t handle) {
+	ParsedClauses *parsed = p_master.p_parsedClauses;
+	return parsed->offsets[handle + 1] - parsed->offsets[handle];
+}
+
+long Master::CnfReadHooks::storedLiteral(uint64_t handle, size_t index) {
+	ParsedClauses *parsed = p_master.p_parsedClauses;
+	BaseDefs::LiteralIndex literal = parsed->literals[parsed->offsets[handle] + index];
+	long input_variable = (literal >> 1) + 1;
+	return (literal & 1) ? input_variable : -input_variable;
 }
 
@@ -25,6 +25,14 @@ void ReducerThread::checkCommand() {
 			p_config.reset();
 			p_config.inputClause(length, literals.begin(), literals.end());
 			p_config.inputFinish();
+		}else if(tag == CommandTag::kParsedClauses) {
+			auto clauses = p_commandConsumer.read<ParsedClauses*>();
+			
+			p_config.reset();
+			p_config.inputShared(clauses->numClauses(),
+					clauses->offsets.data(), clauses->literals.data());
+			p_config.inputFinish();
+			clauses->pendingThreads--;
 		}else SYS_CRITICAL("Illegal reducer command");
 	}
 }
@@ -86,6 +94,7 @@ void ReducerThread::doWork() {
 
 		Activity varGetActivity(Variable var) { return p_reducer.p_config.varGetActivity(var); }
 		Antecedent varAntecedent(Variable var) { return p_reducer.p_config.varAntecedent(var); }
+		bool varImpliedBy(Variable var, Clause clause) { return p_reducer.p_config.varImpliedBy(var, clause); }
 		bool varIsLocked(Variable var) { return p_reducer.p_config.varIsLocked(var); }
 		bool litTrue(Literal lit) { return p_reducer.p_config.litTrue(lit); }
 		bool litFalse(Literal lit) { return p_reducer.p_config.litFalse(lit); }
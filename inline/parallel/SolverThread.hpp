@@ -18,6 +18,13 @@ void SolverThread::checkReduced() {
 				auto literal = SolverConfig::Literal::fromIndex(it->p_reducedConsumer.read<BaseDefs::LiteralIndex>());
 				literals.push_back(literal);
 			}
+
+			// imported clauses are the first to go when memory gets scarce.
+			// units and binary clauses are cheap and always kept
+			if(length > 2 && p_config.memoryPressure() >= SolverConfig::kPressureHigh) {
+				stat.dropped++;
+				continue;
+			}
 			
 			p_config.reset();
 			SolverConfig::Clause clause = p_config.allocClause(length, literals.begin(), literals.end());
@@ -34,6 +41,9 @@ void SolverThread::checkCommand() {
 		p_idleRound = false;
 		
 		auto tag = p_commandConsumer.read<CommandTag>();
+		if(tag != CommandTag::kClause)
+			finishInput();
+
 		if(tag == CommandTag::kExit) {
 			p_threadExitFlag = true;
 		}else if(tag == CommandTag::kProblemDef) {
@@ -51,8 +61,29 @@ void SolverThread::checkCommand() {
 				clause.push_back(literal);
 			}
 			
+			// in online mode clauses arrive while we are searching
+			if(p_searchStarted && !p_restartPending) {
+				p_config.reset();
+				p_restartPending = true;
+			}
 			p_config.inputClause(length, clause.begin(), clause.end());
 			p_config.inputFinish();
+		}else if(tag == CommandTag::kParsedClauses) {
+			auto clauses = p_commandConsumer.read<ParsedClauses*>();
+			
+			p_config.inputShared(clauses->numClauses(),
+					clauses->offsets.data(), clauses->literals.data());
+			p_config.inputFinish();
+			clauses->pendingThreads--;
+		}else if(tag == CommandTag::kInputDone) {
+			p_inputComplete = true;
+			
+			// models that were found before are not reported; search again
+			if(p_searchStarted && !p_solveActive) {
+				p_config.reset();
+				p_config.start();
+				p_solveActive = true;
+			}
 		}else if(tag == CommandTag::kInitialize) {
 			p_config.randomizeVsids();
 			std::cout << "c initialize time: " << sysGetCpuTime() << " ms" << std::endl;
@@ -62,6 +93,7 @@ void SolverThread::checkCommand() {
 			p_config.start();
 
 			p_solveActive = true;
+			p_searchStarted = true;
 		}else if(tag == CommandTag::kAssume) {
 			auto literal = SolverConfig::Literal::fromIndex(p_commandConsumer.read<BaseDefs::LiteralIndex>());
 			
@@ -85,6 +117,16 @@ void SolverThread::checkCommand() {
 			}else SYS_CRITICAL("Variable is not assumed");
 		}else SYS_CRITICAL("Illegal solver command");
 	}
+	finishInput();
+}
+
+// resumes the search after clauses were added during the search
+void SolverThread::finishInput() {
+	if(!p_restartPending)
+		return;
+	p_config.start();
+	p_restartPending = false;
+	p_solveActive = true;
 }
 
 void SolverThread::doWork() {
@@ -96,12 +138,28 @@ void SolverThread::doWork() {
 	satuzk::SolveState result = satuzk::SolveState::kStateUnknown;
 	search(p_config, result, search_total_stats);
 
-	if(result == satuzk::kStateSatisfied) {
+	if(result == satuzk::kStateSatisfied && !p_inputComplete) {
+		// the model is only valid for the clauses that we received so far.
+		// wait until more clauses arrive
+		p_solveActive = false;
+	}else if(result == satuzk::kStateSatisfied) {
 		p_messageProducer.write(MessageTag::kSolvedSat);
 
-		p_messageProducer.write<int>(p_config.numVariables());
-		for(auto var = p_config.varsBegin(); var != p_config.varsEnd(); ++var)
-			p_messageProducer.write<bool>(p_config.litTrue((*var).oneLiteral()));
+		// send the model as a packed bitset
+		p_messageProducer.write<uint64_t>(p_config.numVariables());
+		uint64_t word = 0;
+		uint64_t index = 0;
+		for(auto var = p_config.varsBegin(); var != p_config.varsEnd(); ++var) {
+			if(p_config.litTrue((*var).oneLiteral()))
+				word |= uint64_t(1) << (index % 64);
+			index++;
+			if(index % 64 == 0) {
+				p_messageProducer.write<uint64_t>(word);
+				word = 0;
+			}
+		}
+		if(index % 64 != 0)
+			p_messageProducer.write<uint64_t>(word);
 
 		p_messageProducer.send();
 		p_solveActive = false;
@@ -250,7 +250,7 @@ DistResult DistConfig<Defs>::distill(Hooks &hooks,
 	for(auto i = literals.begin(); i != literals.end(); ++i) {
 		auto var = (*i).variable();
 		if(hooks.litTrue(*i)) {
-			if(hooks.varAntecedent(var) != Hooks::Antecedent::makeClause(clause))
+			if(!hooks.varImpliedBy(var, clause))
 				assertTrue(hooks, clause, *i);
 			break;
 		}else if(hooks.litFalse(*i)) {
@@ -34,10 +34,7 @@ void unhideStamp(Hooks &hooks,
 	stack.push_back(literal);
 
 	bool scc_root = true;
-	for(auto i = hooks.watchBegin(literal); i != hooks.watchEnd(literal); ++i) {
-		if(!(*i).isBinary())
-			continue;
-
+	for(auto i = hooks.binaryBegin(literal); i != hooks.binaryEnd(literal); ++i) {
 		// ignore edges marked as transitive
 		auto bin_clause = (*i).binaryGetClause();
 		if(hooks.clauseIsMarked(bin_clause))
@@ -80,7 +80,9 @@ void sysPerformCritical(const char *file, const int line,
 	__attribute__ (( noreturn, format(printf, 4, 5) ));
 
 void *sysPageAllocate(std::size_t length);
+void *sysPageReallocate(void *pointer, std::size_t old_length, std::size_t new_length);
 void sysPageDeallocate(void *pointer, std::size_t length);
+void sysPageRelease(void *pointer, std::size_t length);
 
 typedef int64_t sys_msecs_t;
 
@@ -0,0 +1,209 @@
+
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+
+namespace sys {
+
+// writes DRAT or LRAT proofs. lines are collected in a large buffer which is
+// handed to a background thread once it is full. the thread writes it
+// to the proof file while the solver fills the other buffer
+class ProofWriter {
+public:
+	enum Format {
+		kFormatBinary,
+		kFormatText
+	};
+
+	ProofWriter() : p_fd(-1), p_format(kFormatBinary), p_lrat(false),
+			p_flushPending(false), p_closing(false) {
+	}
+	~ProofWriter() {
+		if(p_fd != -1)
+			close();
+	}
+	ProofWriter(const ProofWriter &other) = delete;
+	ProofWriter &operator= (const ProofWriter &other) = delete;
+
+	void open(const std::string &file_name, Format format, bool lrat) {
+		assert(p_fd == -1);
+
+		int res = ::open(file_name.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0660);
+		if(res == -1)
+			throw std::runtime_error("Could not open proof file");
+		p_fd = res;
+		p_format = format;
+		p_lrat = lrat;
+		p_buffer.reserve(kBufferSize + kBufferSlack);
+		p_flushBuffer.reserve(kBufferSize + kBufferSlack);
+		p_closing = false;
+		p_thread = std::thread(&ProofWriter::run, this);
+	}
+
+	void close() {
+		assert(p_fd != -1);
+
+		submit();
+		{
+			std::lock_guard<std::mutex> lock(p_mutex);
+			p_closing = true;
+		}
+		p_condition.notify_all();
+		p_thread.join();
+
+		int res = ::close(p_fd);
+		p_fd = -1;
+		if(p_error)
+			std::rethrow_exception(p_error);
+		if(res == -1)
+			throw std::runtime_error("Could not close proof file");
+	}
+
+	bool isOpen() {
+		return p_fd != -1;
+	}
+	bool isLrat() {
+		return p_lrat;
+	}
+
+	// the clause id is only written in lrat mode
+	void beginAdd(uint64_t id) {
+		if(p_format == kFormatBinary) {
+			p_buffer.push_back('a');
+			if(p_lrat)
+				writeNumber(2 * id);
+		}else if(p_lrat) {
+			writeText(id);
+		}
+	}
+	// in lrat mode the id of the last added clause is required
+	// and the deleted clauses are written as hints
+	void beginDelete(uint64_t id) {
+		if(p_format == kFormatText && p_lrat)
+			writeText(id);
+		p_buffer.push_back('d');
+		if(p_format == kFormatText)
+			p_buffer.push_back(' ');
+	}
+
+	// separates the literals of an lrat line from its hints
+	void beginHints() {
+		if(p_format == kFormatBinary) {
+			p_buffer.push_back(0);
+		}else{
+			p_buffer.push_back('0');
+			p_buffer.push_back(' ');
+		}
+	}
+	void writeHint(uint64_t id) {
+		if(p_format == kFormatBinary) {
+			writeNumber(2 * id);
+		}else{
+			writeText(id);
+		}
+	}
+
+	// writes a literal in dimacs numbering
+	void writeLiteral(int64_t number) {
+		if(p_format == kFormatBinary) {
+			// literals are mapped to 2 * var + sign
+			writeNumber(number < 0 ? 2 * (uint64_t)-number + 1 : 2 * (uint64_t)number);
+		}else{
+			char text[24];
+			int length = snprintf(text, sizeof(text), "%lld ", (long long)number);
+			p_buffer.insert(p_buffer.end(), text, text + length);
+		}
+	}
+
+	void endClause() {
+		if(p_format == kFormatBinary) {
+			p_buffer.push_back(0);
+		}else{
+			p_buffer.push_back('0');
+			p_buffer.push_back('\n');
+		}
+		if(p_buffer.size() >= kBufferSize)
+			submit();
+	}
+
+private:
+	static const size_t kBufferSize = 4 * 1024 * 1024;
+	// a single line may exceed the buffer size; avoid reallocations for short lines
+	static const size_t kBufferSlack = 64 * 1024;
+
+	// encodes a number as a sequence of 7-bit groups, least significant group first
+	void writeNumber(uint64_t value) {
+		while(value > 127) {
+			p_buffer.push_back((char)(128 | (value & 127)));
+			value >>= 7;
+		}
+		p_buffer.push_back((char)value);
+	}
+	void writeText(uint64_t value) {
+		char text[24];
+		int length = snprintf(text, sizeof(text), "%llu ", (unsigned long long)value);
+		p_buffer.insert(p_buffer.end(), text, text + length);
+	}
+
+	// passes the current buffer to the writer thread
+	void submit() {
+		std::unique_lock<std::mutex> lock(p_mutex);
+		while(p_flushPending)
+			p_condition.wait(lock);
+		if(p_error)
+			std::rethrow_exception(p_error);
+		p_buffer.swap(p_flushBuffer);
+		p_flushPending = true;
+		p_condition.notify_all();
+	}
+
+	void run() {
+		std::unique_lock<std::mutex> lock(p_mutex);
+		while(true) {
+			while(!p_flushPending && !p_closing)
+				p_condition.wait(lock);
+			if(!p_flushPending)
+				return;
+			lock.unlock();
+
+			try {
+				size_t written = 0;
+				while(written < p_flushBuffer.size()) {
+					ssize_t res = ::write(p_fd, p_flushBuffer.data() + written,
+							p_flushBuffer.size() - written);
+					if(res == -1)
+						throw std::runtime_error("Could not write to proof file");
+					written += res;
+				}
+			}catch(...) {
+				lock.lock();
+				p_error = std::current_exception();
+				lock.unlock();
+			}
+			p_flushBuffer.clear();
+
+			lock.lock();
+			p_flushPending = false;
+			p_condition.notify_all();
+		}
+	}
+
+	int p_fd;
+	Format p_format;
+	bool p_lrat;
+
+	// buffer that is currently filled by the solver
+	std::vector<char> p_buffer;
+	// buffer that is currently written by the writer thread
+	std::vector<char> p_flushBuffer;
+
+	std::thread p_thread;
+	std::mutex p_mutex;
+	std::condition_variable p_condition;
+	std::exception_ptr p_error;
+	bool p_flushPending;
+	bool p_closing;
+};
+
+}; // namespace sys
+
@@ -1,24 +1,29 @@
-
 namespace util {
 namespace memory {
 
-template<typename Index>
+/* allocates objects from a single block of memory.
+ * objects are referenced by their offset divided by the alignment so that
+ * 32-bit indices can address more than 4 GB of memory */
+template<typename Index, uint64_t Alignment>
 class BulkAllocator {
 public:
-	BulkAllocator(Index alignment) : p_memory(NULL), p_alignment(alignment),
-			p_offset(0), p_length(0) { };
+	// largest offset (in bytes) that can be referenced by an index
+	static const uint64_t kMaxOffset = sizeof(Index) >= sizeof(uint64_t)
+			? std::numeric_limits<uint64_t>::max()
+			: (uint64_t)std::numeric_limits<Index>::max() * Alignment;
+
+	BulkAllocator() : p_memory(NULL), p_offset(0), p_length(0) { };
 	BulkAllocator(const BulkAllocator &other) = delete;
 	BulkAllocator &operator= (const BulkAllocator &other) = delete;
 	
 	BulkAllocator &operator= (BulkAllocator &&other) {
 		p_memory = other.p_memory;
-		p_alignment = other.p_alignment;
 		p_offset = other.p_offset;
 		p_length = other.p_length;
 		return *this;
 	}
 	
-	void initMemory(void *pointer, Index length) {
+	void initMemory(void *pointer, uint64_t length) {
 		SYS_ASSERT(SYS_ASRT_GENERAL, p_memory == NULL);
 		SYS_ASSERT(SYS_ASRT_GENERAL, pointer != NULL);
 
@@ -26,42 +31,48 @@ public:
 		p_length = length;
 		p_offset = 0;
 	}
-	void moveTo(void *pointer, Index length) {
-		std::memcpy(pointer, p_memory, p_offset);
+	// the caller has already moved the memory, e.g. by mremap()
+	void remapTo(void *pointer, uint64_t length) {
+		SYS_ASSERT(SYS_ASRT_GENERAL, length >= p_offset);
 		p_memory = pointer;
 		p_length = length;
 	}
 	void *getPointer() {
 		return p_memory;
 	}
-	Index getTotalSpace() {
+	uint64_t getTotalSpace() {
 		return p_length;
 	}
-	Index getFreeSpace() {
+	uint64_t getFreeSpace() {
 		return p_length - p_offset;
 	}
-	Index getUsedSpace() {
+	uint64_t getUsedSpace() {
 		return p_offset;
 	}
 
-	Index alloc(Index length) {
-		Index index = p_offset;
-		if(index % p_alignment != 0)
-			index += p_alignment - index % p_alignment;
-		SYS_ASSERT(SYS_ASRT_GENERAL, index + length < p_length);
-		p_offset = index + length;
-		return index;
+	// frees all objects; the memory is not touched
+	void rewind() {
+		p_offset = 0;
+	}
+
+	Index alloc(uint64_t length) {
+		uint64_t offset = p_offset;
+		if(offset % Alignment != 0)
+			offset += Alignment - offset % Alignment;
+		SYS_ASSERT(SYS_ASRT_GENERAL, offset + length < p_length);
+		SYS_ASSERT(SYS_ASRT_GENERAL, offset <= kMaxOffset);
+		p_offset = offset + length;
+		return offset / Alignment;
 	}
 
 	void *operator[] (Index index) {
-		return (void*)((uintptr_t)p_memory + index);
+		return (void*)((uintptr_t)p_memory + (uint64_t)index * Alignment);
 	}
 		
 private:
 	void *p_memory;
-	Index p_alignment;
-	Index p_offset;
-	Index p_length;
+	uint64_t p_offset;
+	uint64_t p_length;
 };
 
 }}; /* namespace util::memory */
@@ -129,5 +129,101 @@ struct simple {
 	size_type p_capacity;
 };
 
+/* like simple but the memory is taken from a SlabAllocator that is passed
+ * to all functions that allocate memory. the capacity is always the size of
+ * a size class of the allocator. the vector does not free its memory
+ * on destruction; the allocator owns it. */
+template<typename T>
+struct pooled {
+	typedef uint32_t size_type;
+	typedef typename simple<T>::iterator iterator;
+
+	pooled() : p_pointer(NULL), p_size(0), p_capacity(0) { }
+
+	void push_back(util::memory::SlabAllocator &allocator, T value) {
+		if(__builtin_expect(p_size == p_capacity, 0))
+			grow(allocator, p_size + 1);
+		p_pointer[p_size++] = value;
+	}
+	void pop_back() {
+		p_size--;
+	}
+	void erase(iterator it) {
+		for(size_type i = index_of(it); i < p_size - 1; i++)
+			p_pointer[i] = p_pointer[i + 1];
+		p_size--;
+	}
+
+	size_type size() {
+		return p_size;
+	}
+	size_type capacity() {
+		return p_capacity;
+	}
+	iterator begin() {
+		return iterator(p_pointer);
+	}
+	iterator end() {
+		return iterator(p_pointer + p_size);
+	}
+	size_type index_of(iterator it) {
+		return it.p_pointer - p_pointer;
+	}
+
+	void resize(size_type new_size) {
+		p_size = new_size;
+	}
+	void clear() {
+		resize(0);
+	}
+
+	// moves the elements to a block that can hold at least new_capacity elements
+	void reallocate(util::memory::SlabAllocator &allocator, size_type new_capacity) {
+		T *old_pointer = p_pointer;
+		size_type old_capacity = p_capacity;
+		relocate(allocator, new_capacity);
+		if(old_pointer != NULL)
+			allocator.free(old_pointer, classOf(old_capacity));
+	}
+	/* like reallocate() but the old block is not returned to the allocator.
+	 * used during compaction of the allocator */
+	void relocate(util::memory::SlabAllocator &allocator, size_type new_capacity) {
+		if(new_capacity < p_size)
+			new_capacity = p_size;
+		T *new_pointer = NULL;
+		size_type capacity = 0;
+		if(new_capacity > 0) {
+			int size_class = classOf(new_capacity);
+			new_pointer = reinterpret_cast<T*>(allocator.alloc(size_class));
+			capacity = util::memory::SlabAllocator::classBytes(size_class) / sizeof(T);
+			std::memcpy(new_pointer, p_pointer, sizeof(T) * p_size);
+		}
+		p_pointer = new_pointer;
+		p_capacity = capacity;
+	}
+	void shrink_to_fit(util::memory::SlabAllocator &allocator) {
+		if(p_capacity == 0)
+			return;
+		if(p_size > 0 && classOf(p_size) == classOf(p_capacity))
+			return;
+		reallocate(allocator, p_size);
+	}
+
+	T *p_pointer;
+	size_type p_size;
+	size_type p_capacity;
+
+private:
+	static int classOf(size_type capacity) {
+		return util::memory::SlabAllocator::sizeClass(sizeof(T) * (uint64_t)capacity);
+	}
+
+	__attribute__((noinline)) void grow(util::memory::SlabAllocator &allocator,
+			size_type new_size) {
+		reallocate(allocator, 2 * new_size);
+	}
+};
+
 }};
 
+
@@ -0,0 +1,140 @@
+
+namespace util {
+namespace memory {
+
+/* allocates small blocks of memory from large slabs.
+ * block sizes are rounded up to powers of two; freed blocks are kept on
+ * a free list for each size class and are reused by later allocations.
+ * compaction is driven by the owner of the blocks: after beginCompaction()
+ * all allocations are served from fresh slabs so that blocks that are
+ * allocated one after another are placed next to each other in memory.
+ * endCompaction() releases the old slabs */
+class SlabAllocator {
+public:
+	// the smallest block must be able to hold a free list pointer
+	static const int kMinShift = 3;
+	static const int kNumClasses = 48;
+	static const uint64_t kSlabSize = 1024 * 1024;
+	// blocks of at least this size get a slab of their own
+	static const uint64_t kLargeBlock = kSlabSize / 4;
+
+	SlabAllocator() : p_current(NULL), p_offset(0), p_length(0),
+			p_totalSpace(0), p_freeSpace(0) {
+		for(int i = 0; i < kNumClasses; i++)
+			p_freeLists[i] = NULL;
+	}
+	~SlabAllocator() {
+		releaseSlabs(p_slabs);
+		releaseSlabs(p_oldSlabs);
+	}
+	SlabAllocator(const SlabAllocator &other) = delete;
+	SlabAllocator &operator= (const SlabAllocator &other) = delete;
+
+	static int sizeClass(uint64_t bytes) {
+		int size_class = 0;
+		while(classBytes(size_class) < bytes)
+			size_class++;
+		SYS_ASSERT(SYS_ASRT_GENERAL, size_class < kNumClasses);
+		return size_class;
+	}
+	static uint64_t classBytes(int size_class) {
+		return (uint64_t)1 << (size_class + kMinShift);
+	}
+
+	void *alloc(int size_class) {
+		void *block = p_freeLists[size_class];
+		if(block != NULL) {
+			p_freeLists[size_class] = *(void**)block;
+			p_freeSpace -= classBytes(size_class);
+			return block;
+		}
+
+		uint64_t bytes = classBytes(size_class);
+		if(bytes >= kLargeBlock)
+			return newSlab(bytes);
+		if(p_offset + bytes > p_length) {
+			p_current = newSlab(kSlabSize);
+			p_offset = 0;
+			p_length = kSlabSize;
+		}
+		block = (char*)p_current + p_offset;
+		p_offset += bytes;
+		return block;
+	}
+	void free(void *block, int size_class) {
+		*(void**)block = p_freeLists[size_class];
+		p_freeLists[size_class] = block;
+		p_freeSpace += classBytes(size_class);
+	}
+
+	// total size of all slabs
+	uint64_t getTotalSpace() {
+		return p_totalSpace;
+	}
+	// size of the blocks on the free lists
+	uint64_t getFreeSpace() {
+		return p_freeSpace;
+	}
+
+	void beginCompaction() {
+		SYS_ASSERT(SYS_ASRT_GENERAL, p_oldSlabs.empty());
+		p_oldSlabs.swap(p_slabs);
+		forget();
+	}
+	// the blocks that were not reallocated since beginCompaction() become invalid
+	void endCompaction() {
+		releaseSlabs(p_oldSlabs);
+	}
+
+	// frees all blocks and returns the memory to the os
+	void reset() {
+		releaseSlabs(p_slabs);
+		forget();
+	}
+
+private:
+	struct Slab {
+		void *pointer;
+		uint64_t length;
+	};
+
+	void *newSlab(uint64_t length) {
+		Slab slab;
+		slab.pointer = sysPageAllocate(length);
+		slab.length = length;
+		p_slabs.push_back(slab);
+		p_totalSpace += length;
+		return slab.pointer;
+	}
+	void releaseSlabs(std::vector<Slab> &slabs) {
+		for(auto it = slabs.begin(); it != slabs.end(); ++it)
+			sysPageDeallocate((*it).pointer, (*it).length);
+		slabs.clear();
+	}
+	// drops the free lists and the current slab
+	void forget() {
+		for(int i = 0; i < kNumClasses; i++)
+			p_freeLists[i] = NULL;
+		p_current = NULL;
+		p_offset = 0;
+		p_length = 0;
+		p_totalSpace = 0;
+		p_freeSpace = 0;
+	}
+
+	std::vector<Slab> p_slabs;
+	// slabs that are released by endCompaction()
+	std::vector<Slab> p_oldSlabs;
+	void *p_freeLists[kNumClasses];
+
+	// slab that small blocks are currently taken from
+	void *p_current;
+	uint64_t p_offset;
+	uint64_t p_length;
+
+	uint64_t p_totalSpace;
+	uint64_t p_freeSpace;
+};
+
+}}; /* namespace util::memory */
+
@@ -14,6 +14,10 @@
 #include <cstring>
 #include <csignal>
 #include <thread>
+#include <limits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "../Config.hpp"
 
@@ -21,8 +25,10 @@
 
 #include "../inline/sys/Debug.hpp"
 #include "../inline/sys/Reporter.hpp"
+#include "../inline/sys/ProofWriter.hpp"
 #include "../inline/sys/Performance.hpp"
 #include "../inline/util/BulkAlloc.hpp"
+#include "../inline/util/SlabAlloc.hpp"
 #include "../inline/util/BinaryHeap.hpp"
 #include "../inline/util/Bool3.hpp"
 #include "../inline/util/SimpleVector.hpp"
@@ -42,7 +48,9 @@
 #include "../inline/Vsids.hpp"
 #include "../inline/ExtModel.hpp"
 #include "../inline/simplify/Distillation.hpp"
+#include "../inline/Decompress.hpp"
 #include "../inline/Dimacs.hpp"
+#include "../inline/ModelWriter.hpp"
 #include "../include/Config.hpp"
 #include "../inline/Config.hpp"
 
@@ -57,10 +65,13 @@ struct BaseDefs {
 	typedef uint32_t Order;
 	typedef double Activity;
 	typedef uint32_t Declevel;
+	// threads refer to the original clauses instead of copying them
+	static const bool kSharedClauses = true;
 };
 
 volatile bool globalExitFlag = false;
 
+#include "../include/parallel/ParsedClauses.hpp"
 #include "../include/parallel/SolverThread.hpp"
 #include "../include/parallel/ReducerThread.hpp"
 #include "../include/parallel/Master.hpp"
@@ -101,6 +112,12 @@ int main(int argc, char **argv) {
 
 	std::string instance;
 	std::string model_file;
+	std::string binary_model_file;
+	int parse_threads = std::thread::hardware_concurrency();
+	bool detect_duplicates = true;
+	bool parse_once = false;
+	bool online_input = false;
+	uint64_t mem_limit = 0;
 	for(auto i = args.begin(); i != args.end(); /* no increment here */) {
 		if(*i == "-show-model") {
 			show_model = true;
@@ -113,7 +130,40 @@ int main(int argc, char **argv) {
 			}
 			model_file = *i;
 			++i;
-		}else if((*i).at(0) == '-') {
+		}else if(*i == "-save-model-binary") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -save-model-binary" << std::endl;
+				return 0;
+			}
+			binary_model_file = *i;
+			++i;
+		}else if(*i == "-parse-threads") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -parse-threads" << std::endl;
+				return 0;
+			}
+			parse_threads = std::atoi((*i).c_str());
+			++i;
+		}else if(*i == "-no-duplicate-check") {
+			detect_duplicates = false;
+			++i;
+		}else if(*i == "-parse-once") {
+			parse_once = true;
+			++i;
+		}else if(*i == "-online") {
+			online_input = true;
+			++i;
+		}else if(*i == "-mem-limit") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -mem-limit" << std::endl;
+				return 0;
+			}
+			mem_limit = std::atoll((*i).c_str()) * 1024 * 1024;
+			++i;
+		}else if((*i).at(0) == '-' && *i != "-") {
 			std::cout << "Illegal command line parameter '" << (*i) << "'" << std::endl;
 			return 0;
 		}else{
@@ -129,6 +179,10 @@ int main(int argc, char **argv) {
 	}
 
 	SYS_ASSERT(SYS_ASRT_GENERAL, instance.length() > 0);
+	if(parse_once && online_input) {
+		std::cout << "-parse-once cannot be combined with -online" << std::endl;
+		return 0;
+	}
 
 	auto start_time = sysGetWallTime();
 
@@ -140,34 +194,36 @@ int main(int argc, char **argv) {
 #endif
 
 	Master master(instance);
+	master.opts.parseThreads = parse_threads;
+	master.opts.detectDuplicates = detect_duplicates;
+	master.opts.parseOnce = parse_once;
+	master.opts.onlineInput = online_input;
+	master.opts.memLimit = mem_limit;
 	int exit_code = master.run();
 
 	if(show_model) {
 		if(exit_code == 10) {
-			std::cout << "v";
-			for(auto it = master.beginModel(); it != master.endModel(); ++it)
-				std::cout << " " << *it;
-			std::cout << " 0" << std::endl;
+			satuzk::ModelWriter writer(std::cout);
+			writer.writeVLine(master.getModel());
 		}
+		std::cout.flush();
 	}
 	
 	if(model_file.length() > 0) {
 		std::fstream model_stream(model_file,
 				std::fstream::out | std::fstream::trunc);
 		if(exit_code == 10) {
-			model_stream << "SAT\n";
-			
-			for(auto it = master.beginModel(); it != master.endModel(); ++it) {
-				if(it != master.beginModel())
-					model_stream << " ";
-				model_stream << *it;
-			}
-			model_stream << " 0\n";
+			satuzk::ModelWriter writer(model_stream);
+			writer.writeString("SAT\n");
+			writer.writeLiterals(master.getModel());
+			writer.writeString("0\n");
 		}else if(exit_code == 20) {
 			model_stream << "UNSAT\n";
 		}else model_stream << "INDET\n";
 		model_stream.close();
 	}
+	if(binary_model_file.length() > 0)
+		satuzk::writeBinaryModel(binary_model_file, exit_code, master.getModel());
 
 #ifdef FEATURE_GOOGLE_PROFILE
 	ProfilerStop();	
@@ -15,13 +15,20 @@
 #include <cstring>
 #include <csignal>
 #include <cassert>
+#include <thread>
+#include <limits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "../Config.hpp"
 
 #include "../inline/sys/Debug.hpp"
 #include "../inline/sys/Reporter.hpp"
+#include "../inline/sys/ProofWriter.hpp"
 #include "../inline/sys/Performance.hpp"
 #include "../inline/util/BulkAlloc.hpp"
+#include "../inline/util/SlabAlloc.hpp"
 #include "../inline/util/BinaryHeap.hpp"
 #include "../inline/util/Bool3.hpp"
 #include "../inline/util/SimpleVector.hpp"
@@ -46,8 +53,11 @@
 #include "../inline/simplify/Subsumption.hpp"
 #include "../inline/simplify/Unhiding.hpp"
 #include "../inline/simplify/Equivalent.hpp"
+#include "../inline/Decompress.hpp"
 #include "../inline/Dimacs.hpp"
+#include "../inline/ModelWriter.hpp"
 #include "../inline/Config.hpp"
+#include "../inline/BinaryCnf.hpp"
 
 #ifdef FEATURE_GOOGLE_PROFILE
 #include <google/profiler.h>
@@ -60,19 +70,31 @@ struct BaseDefs {
 	typedef uint32_t Order;
 	typedef double Activity;
 	typedef uint32_t Declevel;
+	// original clauses are copied into the clause arena
+	static const bool kSharedClauses = false;
+};
+
+// used for instances whose clause space might exceed
+// the range of 32-bit clause indices
+struct BaseDefsHuge : BaseDefs {
+	typedef uint64_t ClauseIndex;
 };
 
 struct OurHooks {
-	void onLearnedClause(satuzk::ClauseType<BaseDefs> clause) { }
+	template<typename Clause>
+	void onLearnedClause(Clause clause) { }
 };
 
 typedef satuzk::Config<BaseDefs, OurHooks> OurConfig;
+typedef satuzk::Config<BaseDefsHuge, OurHooks> HugeConfig;
 
-OurConfig *the_config = new OurConfig(OurHooks(), 1);
+// set by the signal handler to stop the solver
+volatile bool *the_stop_flag = nullptr;
 
+template<typename Config>
 class CnfReadHooks {
 public:
-	CnfReadHooks(OurConfig &config) : p_config(config) { }
+	CnfReadHooks(Config &config) : p_config(config) { }
 	
 	void onProblem(long num_vars, long num_clauses) {
 		p_config.varReserve(num_vars);
@@ -82,15 +104,15 @@ public:
 		std::cout << "c var memory: " << sysPeakMemory() << " kb" << std::endl;
 	}
 
-	void onClause(std::vector<long> &in_clause) {
+	uint64_t onClause(std::vector<long> &in_clause) {
 		// transform input variable ids to internal variable ids
-		std::vector<typename OurConfig::Literal> out_clause;
+		std::vector<typename Config::Literal> out_clause;
 		for(auto it = in_clause.begin(); it != in_clause.end(); ++it) {
 			long input_variable = (*it) < 0 ? -(*it) : (*it);
 			SYS_ASSERT(SYS_ASRT_GENERAL, input_variable <= p_varCount);
 			
-			typename OurConfig::Variable intern_variable = internVariable(input_variable);
-			typename OurConfig::Literal intern_literal = (*it) < 0
+			typename Config::Variable intern_variable = internVariable(input_variable);
+			typename Config::Literal intern_literal = (*it) < 0
 					? intern_variable.zeroLiteral()
 					: intern_variable.oneLiteral();
 			out_clause.push_back(intern_literal);
@@ -100,21 +122,36 @@ public:
 		//std::shuffle(out_clause.begin(), out_clause.end(),
 		//		p_config.p_rndEngine);
 		
-		p_config.inputClause(out_clause.size(),
+		typename Config::Clause clause = p_config.inputClause(out_clause.size(),
 				out_clause.begin(), out_clause.end());
+		return clause.getIndex();
+	}
+	void onDroppedClause() {
+		// lrat proofs refer to input clauses by their position
+		p_config.inputSkip();
+	}
+
+	// the clause normalizer compares new clauses to the stored ones
+	size_t storedLength(uint64_t handle) {
+		return p_config.clauseLength(Config::Clause::fromIndex(handle));
+	}
+	long storedLiteral(uint64_t handle, size_t index) {
+		return p_config.clauseGetLiteral(Config::Clause::fromIndex(handle),
+				index).toNumber();
 	}
 
 	int numVariables() { return p_varCount; }
-	typename OurConfig::Variable internVariable(int input_variable) {
-		return OurConfig::Variable::fromIndex(input_variable - 1);
+	typename Config::Variable internVariable(int input_variable) {
+		return Config::Variable::fromIndex(input_variable - 1);
 	}
 
 private:
 	long p_varCount;
-	OurConfig &p_config;
+	Config &p_config;
 };
 
-satuzk::SolveState solve(OurConfig &config) {
+template<typename Config>
+satuzk::SolveState solve(Config &config) {
 	if(config.opts.general.verbose >= 1) {
 		std::cout << "c [      ]  initial:" << std::endl;
 		std::cout << "c [      ]     variables: " << config.p_varConfig.presentCount()
@@ -123,22 +160,25 @@ satuzk::SolveState solve(OurConfig &config) {
 	}
 	
 	// perform preprocessing	
-	if(config.opts.general.verbose >= 1)
-		std::cout << "c building occurrence lists" << std::endl;
-	config.occurConstruct();
-
-	auto preproc_start = sys::hptCurrent();
-
-	UnhideRunStats stat_unhide;
-	bceEliminateAll(config);
-	vecdEliminateAll(config);
-	selfsubEliminateAll(config);
-	for(int i = 0; i < 5; i++)
-		unhideEliminateAll(config, true, stat_unhide);
-
-	config.perf.preprocTime += sys::hptElapsed(preproc_start);
-	
-	config.occurDestruct();
+	// the preprocessors do not generate lrat hints
+	if(!config.lratEnabled()) {
+		if(config.opts.general.verbose >= 1)
+			std::cout << "c building occurrence lists" << std::endl;
+		config.occurConstruct();
+
+		auto preproc_start = sys::hptCurrent();
+
+		UnhideRunStats stat_unhide;
+		bceEliminateAll(config);
+		vecdEliminateAll(config);
+		selfsubEliminateAll(config);
+		for(int i = 0; i < 5; i++)
+			unhideEliminateAll(config, true, stat_unhide);
+
+		config.perf.preprocTime += sys::hptElapsed(preproc_start);
+		
+		config.occurDestruct();
+	}
 	
 	// start the search
 	if(config.opts.general.verbose >= 1) {
@@ -187,9 +227,63 @@ void onInterrupt(int sig) {
 		default: std::cout << sig;
 	}
 	std::cout << std::endl;
-	the_config->state.general.stopSolve = true;
+	if(the_stop_flag != nullptr)
+		*the_stop_flag = true;
+}
+
+// estimates the size of the uncompressed instance
+uint64_t estimateInstanceSize(int fd) {
+	// typical compression ratio of cnf files
+	static const uint64_t kCompressRatio = 8;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0)
+		throw std::runtime_error("Could not stat input");
+	if(!S_ISREG(st.st_mode))
+		return 0;
+
+	char magic[sys::kCompressMagicLength];
+	ssize_t len = pread(fd, magic, sys::kCompressMagicLength, 0);
+	if(len == -1)
+		throw std::runtime_error("Could not read input");
+	if(sys::detectCompression(magic, len) != sys::kCompressNone)
+		return st.st_size * kCompressRatio;
+	return st.st_size;
 }
 
+// parameters that are passed from main() to runSolver()
+struct SeqOptions {
+	int verbose;
+	sys::HptCounter budget;
+	sys::HptCounter timeout;
+	bool setSeed;
+	int seed;
+
+	bool showModel;
+	std::string modelFile;
+	std::string binaryModelFile;
+	std::vector<int> assumptions;
+	int parseThreads;
+	bool detectDuplicates;
+	std::string dumpFile;
+	bool loadBinary;
+	std::string proofFile;
+	bool proofLrat;
+	sys::ProofWriter::Format proofFormat;
+	bool layoutClauses;
+	uint64_t memLimit;
+
+	SeqOptions() : verbose(1), budget(0), timeout(0), setSeed(false), seed(0),
+			showModel(false), parseThreads(std::thread::hardware_concurrency()),
+			detectDuplicates(true), loadBinary(false), proofLrat(false),
+			proofFormat(sys::ProofWriter::kFormatBinary),
+			layoutClauses(false), memLimit(0) { }
+};
+
+template<typename Config>
+int runSolver(SeqOptions &options, int instance_fd);
+
+
 int main(int argc, char **argv) {
 	std::cout << "c this is satUZK-seq, '" << CONFIG_BRANCH << "' branch" << std::endl;
 	std::cout << "c revision " << CONFIG_REVISION
@@ -204,9 +298,6 @@ int main(int argc, char **argv) {
 		std::cout << ' ' << argv[i];
 	std::cout << std::endl;
 
-	OurConfig &config = *the_config;
-	config.opts.general.verbose = 1;
-
 	if(signal(SIGINT, onInterrupt) == SIG_ERR
 			|| signal(SIGXCPU, onInterrupt) == SIG_ERR)
 		throw std::runtime_error("Could not install signal handler");
@@ -216,14 +307,12 @@ int main(int argc, char **argv) {
 	for(int i = 1; i < argc; ++i)
 		args.push_back(std::string(argv[i]));
 
-	bool show_model = false;
-
+	SeqOptions options;
 	std::string instance;
-	std::string model_file;
-	std::vector<int> assumptions;
+	bool huge_clauses = false;
 	for(auto i = args.begin(); i != args.end(); /* no increment here */) {
 		if(*i == "-v") {
-			config.opts.general.verbose = 3;
+			options.verbose = 3;
 			++i;
 		}else if(*i == "-budget") {
 			++i;
@@ -231,7 +320,7 @@ int main(int argc, char **argv) {
 				std::cout << "Expected argument for -budget" << std::endl;
 				return 0;
 			}
-			config.opts.general.budget = std::atoi((*i).c_str())
+			options.budget = std::atoi((*i).c_str())
 					* 1000LL * 1000LL * 1000LL;
 			++i;
 		}else if(*i == "-timeout") {
@@ -240,9 +329,9 @@ int main(int argc, char **argv) {
 				std::cout << "Expected argument for -timeout" << std::endl;
 				return 0;
 			}
-			config.opts.general.budget = std::atoi((*i).c_str())
+			options.budget = std::atoi((*i).c_str())
 					* 1000LL * 1000LL * 1000LL;
-			config.opts.general.timeout = std::atoi((*i).c_str())
+			options.timeout = std::atoi((*i).c_str())
 					* 1000LL * 1000LL * 1000LL;
 			++i;
 		}else if(*i == "-seed") {
@@ -251,7 +340,8 @@ int main(int argc, char **argv) {
 				std::cout << "Expected argument for -seed" << std::endl;
 				return 0;
 			}
-			config.seedRandomEngine(std::atoi((*i).c_str()));
+			options.setSeed = true;
+			options.seed = std::atoi((*i).c_str());
 			++i;
 		}else if(*i == "-assume") {
 			++i;
@@ -259,10 +349,10 @@ int main(int argc, char **argv) {
 				std::cout << "Expected argument for -assume" << std::endl;
 				return 0;
 			}
-			assumptions.push_back(std::stoi((*i)));
+			options.assumptions.push_back(std::stoi((*i)));
 			++i;
 		}else if(*i == "-show-model") {
-			show_model = true;
+			options.showModel = true;
 			++i;
 		}else if(*i == "-save-model") {
 			++i;
@@ -270,10 +360,72 @@ int main(int argc, char **argv) {
 				std::cout << "Expected argument for -save_model" << std::endl;
 				return 0;
 			}
-			model_file = *i;
+			options.modelFile = *i;
+			++i;
+		}else if(*i == "-save-model-binary") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -save-model-binary" << std::endl;
+				return 0;
+			}
+			options.binaryModelFile = *i;
+			++i;
+		}else if(*i == "-parse-threads") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -parse-threads" << std::endl;
+				return 0;
+			}
+			options.parseThreads = std::atoi((*i).c_str());
+			++i;
+		}else if(*i == "-dump-binary") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -dump-binary" << std::endl;
+				return 0;
+			}
+			options.dumpFile = *i;
+			++i;
+		}else if(*i == "-load-binary") {
+			options.loadBinary = true;
+			++i;
+		}else if(*i == "-huge-clauses") {
+			huge_clauses = true;
+			++i;
+		}else if(*i == "-no-duplicate-check") {
+			options.detectDuplicates = false;
 			++i;
 		}else if(*i == "-drat-proof") {
-			config.opts.general.outputDratProof = true;
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -drat-proof" << std::endl;
+				return 0;
+			}
+			options.proofFile = *i;
+			options.proofLrat = false;
+			++i;
+		}else if(*i == "-lrat-proof") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -lrat-proof" << std::endl;
+				return 0;
+			}
+			options.proofFile = *i;
+			options.proofLrat = true;
+			++i;
+		}else if(*i == "-proof-text") {
+			options.proofFormat = sys::ProofWriter::kFormatText;
+			++i;
+		}else if(*i == "-layout-clauses") {
+			options.layoutClauses = true;
+			++i;
+		}else if(*i == "-mem-limit") {
+			++i;
+			if(i == args.end()) {
+				std::cout << "Expected argument for -mem-limit" << std::endl;
+				return 0;
+			}
+			options.memLimit = std::atoll((*i).c_str()) * 1024 * 1024;
 			++i;
 		}else if((*i).at(0) == '-') {
 			std::cout << "Illegal command line parameter '" << (*i) << "'" << std::endl;
@@ -291,6 +443,50 @@ int main(int argc, char **argv) {
 	}
 
 	SYS_ASSERT(SYS_ASRT_GENERAL, instance.length() > 0);
+	if(options.proofLrat && (options.loadBinary || options.assumptions.size() > 0)) {
+		std::cout << "-lrat-proof cannot be combined with -load-binary or -assume" << std::endl;
+		return 0;
+	}
+
+	int instance_fd = open(instance.c_str(), O_RDONLY);
+	if(instance_fd == -1)
+		throw std::runtime_error("Could not read input file");
+
+	// 32-bit clause indices cover 8 GB of original clauses. the clause space
+	// is usually a small multiple of the instance size. snapshots store
+	// the size of their clauses in the header
+	static const uint64_t kHugeInstanceSize = 4ULL * 1024 * 1024 * 1024;
+	uint64_t instance_size = options.loadBinary ? satuzk::estimateBinaryCnfSize(instance_fd)
+			: estimateInstanceSize(instance_fd);
+	if(instance_size > kHugeInstanceSize) {
+		huge_clauses = true;
+	}
+	
+	if(huge_clauses) {
+		std::cout << "c using 64-bit clause indices" << std::endl;
+		return runSolver<HugeConfig>(options, instance_fd);
+	}
+	return runSolver<OurConfig>(options, instance_fd);
+}
+
+template<typename Config>
+int runSolver(SeqOptions &options, int instance_fd) {
+	Config *the_config = new Config(OurHooks(), 1);
+	Config &config = *the_config;
+	config.opts.general.verbose = options.verbose;
+	config.opts.general.budget = options.budget;
+	config.opts.general.timeout = options.timeout;
+	config.opts.general.layoutClauses = options.layoutClauses;
+	config.opts.general.memLimit = options.memLimit;
+	if(options.setSeed)
+		config.seedRandomEngine(options.seed);
+	the_stop_flag = &config.state.general.stopSolve;
+
+	sys::ProofWriter proof_writer;
+	if(options.proofFile.length() > 0) {
+		proof_writer.open(options.proofFile, options.proofFormat, options.proofLrat);
+		config.p_proofWriter = &proof_writer;
+	}
 
 #ifdef FEATURE_GOOGLE_PROFILE
 	char profile[256];
@@ -299,13 +495,14 @@ int main(int argc, char **argv) {
 	ProfilerStart(profile);
 #endif
 	
-	int instance_fd = open(instance.c_str(), O_RDONLY);
-	if(instance_fd == -1)
-		throw std::runtime_error("Could not read input file");
-
-	CnfReadHooks read_hooks(config);
-	CnfParser<CnfReadHooks> reader(read_hooks, instance_fd);
-	reader.parse();
+	long num_vars;
+	if(options.loadBinary) {
+		num_vars = satuzk::loadBinaryCnf(config, instance_fd);
+	}else{
+		CnfReadHooks<Config> read_hooks(config);
+		parseCnf(read_hooks, instance_fd, options.parseThreads, options.detectDuplicates);
+		num_vars = read_hooks.numVariables();
+	}
 	config.inputFinish();
 	
 	if(close(instance_fd) != 0)
@@ -314,33 +511,58 @@ int main(int argc, char **argv) {
 	std::cout << "c parse time: " << sysGetCpuTime() << " ms" << std::endl;
 	std::cout << "c parse memory: " << sysPeakMemory() << " kb" << std::endl;
 
-	for(auto it = assumptions.begin(); it != assumptions.end(); ++it) {
-		OurConfig::Literal literal = OurConfig::Literal::fromNumber(*it);
+	if(options.dumpFile.length() > 0) {
+		satuzk::dumpBinaryCnf(config, num_vars, options.dumpFile);
+		std::cout << "c wrote binary cnf to " << options.dumpFile << std::endl;
+		the_stop_flag = nullptr;
+		delete the_config;
+		return 0;
+	}
+
+	for(auto it = options.assumptions.begin(); it != options.assumptions.end(); ++it) {
+		typename Config::Literal literal = Config::Literal::fromNumber(*it);
 		config.lockVariable(literal.variable());
 		config.assumptionEnable(literal);
 	}
 
 	satuzk::SolveState result = solve(config);
 
-	if(model_file.length() > 0) {
-		std::fstream model_stream(model_file,
+	if(proof_writer.isOpen()) {
+		// the proof ends with the empty clause
+		if(result == satuzk::kStateUnsatisfiable)
+			config.proofEmptyClause();
+		proof_writer.close();
+	}
+
+	// free variables are omitted from v lines and written as false otherwise
+	satuzk::PackedModel packed_model;
+	if(result == satuzk::kStateSatisfied) {
+		std::vector<Bool3> model;
+		model.resize(num_vars + 1, undefined3());
+		config.p_extModelConfig.buildModel(config, model);
+
+		packed_model.resize(num_vars);
+		for(long i = 1; i <= num_vars; ++i) {
+			if(model[i].isTrue()) {
+				packed_model.setTrue(i);
+			}else if(!model[i].isFalse()) {
+				packed_model.setFree(i);
+			}
+		}
+	}
+
+	if(options.binaryModelFile.length() > 0)
+		satuzk::writeBinaryModel(options.binaryModelFile, result == satuzk::kStateSatisfied ? 10
+				: (result == satuzk::kStateUnsatisfiable ? 20 : 0), packed_model);
+
+	if(options.modelFile.length() > 0) {
+		std::fstream model_stream(options.modelFile,
 				std::fstream::out | std::fstream::trunc);
 		if(result == satuzk::kStateSatisfied) {
-			model_stream << "SAT\n";
-			
-			std::vector<Bool3> model;
-			model.resize(read_hooks.numVariables() + 1, undefined3());
-			config.p_extModelConfig.buildModel(config, model);
-			
-			for(long i = 1; i <= read_hooks.numVariables(); ++i) {
-				if(i != 1)
-					model_stream << " ";
-				// TODO: don't include non-assigned variables?
-				if(model[i].isTrue()) {
-					model_stream << i;
-				}else model_stream << -i;
-			}
-			model_stream << " 0\n";
+			satuzk::ModelWriter writer(model_stream);
+			writer.writeString("SAT\n");
+			writer.writeLiterals(packed_model);
+			writer.writeString("0\n");
 		}else if(result == satuzk::kStateUnsatisfiable) {
 			model_stream << "UNSAT\n";
 		}else model_stream << "INDET\n";
@@ -348,26 +570,14 @@ int main(int argc, char **argv) {
 	}else{
 		if(result == satuzk::kStateSatisfied) {
 			std::cout << "s SATISFIABLE" << std::endl;
-
-			std::vector<Bool3> model;
-			model.resize(read_hooks.numVariables() + 1, undefined3());
-			config.p_extModelConfig.buildModel(config, model);
 			
-			if(show_model) {
-				std::cout << "v";
-				bool free_variables = false;
-				for(long i = 1; i <= read_hooks.numVariables(); ++i) {
-					// TODO: don't include non-assigned variables?
-					if(model[i].isTrue()) {
-						std::cout << " " << i;
-					}else if(model[i].isFalse()) {
-						std::cout << " " << -i;
-					}else{
-						free_variables = true;
-					}
+			if(options.showModel) {
+				{
+					satuzk::ModelWriter writer(std::cout);
+					writer.writeVLine(packed_model, true);
 				}
-				std::cout << " 0" << std::endl;
-				if(free_variables)
+				std::cout.flush();
+				if(packed_model.hasFree())
 					std::cout << "c There were free variables!" << std::endl;
 			}
 		}else if(result == satuzk::kStateUnsatisfiable) {
@@ -389,6 +599,12 @@ int main(int argc, char **argv) {
 	std::cout << "c peak memory: " << sysPeakMemory() << " kb" << std::endl;
 	std::cout << "c    [      ] clause reallocations: " << config.stat.general.clauseReallocs
 		<< ", collections: " << config.stat.general.clauseCollects << std::endl;
+	std::cout << "c    [      ] watch list compactions: "
+		<< config.stat.general.watchCompacts << std::endl;
+	if(config.opts.general.memLimit != 0)
+		std::cout << "c    [      ] memory usage: " << (config.memoryUsage() / 1024)
+			<< " kb, limit: " << (config.opts.general.memLimit / 1024)
+			<< " kb, peak pressure: " << config.stat.general.peakPressure << std::endl;
 
 	std::cout << "c ------ search ------" << std::endl;
 	std::cout << "c    conflicts: " << config.conflictNum;
@@ -418,6 +634,8 @@ int main(int argc, char **argv) {
 		<< ", active: " << (100.0f * config.stat.clauseRed.clausesActive
 			/ (config.stat.clauseRed.clausesActive + config.stat.clauseRed.clausesNotActive)) << "%"
 		<< ", learnts limit: " << config.state.clauseRed.geomSizeLimit << std::endl;
+	std::cout << "c    frozen clause store: "
+		<< (config.p_clauseConfig.frozenStoreBytes() / 1024) << " kb" << std::endl;
 	
 	std::cout << "c ------ simplification ------" << std::endl;
 	std::cout << "c    [VECD  ]  vars eliminated: " << config.stat.simp.vecdEliminated
@@ -451,6 +669,7 @@ int main(int argc, char **argv) {
 	std::cout << "c    [      ]  preprocessing: "
 			<< (config.perf.preprocTime / (1000 * 1000)) << " ms" << std::endl;
 
+	the_stop_flag = nullptr;
 	delete the_config;
 
 	if(result == satuzk::kStateSatisfied) {
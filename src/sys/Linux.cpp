@@ -69,13 +69,32 @@ void sysPerformCritical(const char *file, const int line,
 void *sysPageAllocate(size_t length) {
 	void *pointer = mmap(NULL, length, PROT_READ | PROT_WRITE,
 			MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-	SYS_ASSERT(0, pointer != MAP_FAILED);
+	if(pointer == MAP_FAILED)
+		SYS_CRITICAL("Out of memory\n");
 	return pointer;
 }
+void *sysPageReallocate(void *pointer, size_t old_length, size_t new_length) {
+	// the kernel moves the page mappings; the data is not copied
+	void *new_pointer = mremap(pointer, old_length, new_length, MREMAP_MAYMOVE);
+	if(new_pointer == MAP_FAILED)
+		SYS_CRITICAL("Out of memory\n");
+	return new_pointer;
+}
 void sysPageDeallocate(void *pointer, size_t length) {
 	int result = munmap(pointer, length);
 	SYS_ASSERT(0, result != -1);
 }
+void sysPageRelease(void *pointer, size_t length) {
+	// only whole pages can be released; the memory stays mapped
+	// and reads as zero when it is touched again
+	uintptr_t page_size = sysconf(_SC_PAGESIZE);
+	uintptr_t begin = ((uintptr_t)pointer + page_size - 1) & ~(page_size - 1);
+	uintptr_t end = ((uintptr_t)pointer + length) & ~(page_size - 1);
+	if(begin >= end)
+		return;
+	int result = madvise((void*)begin, end - begin, MADV_DONTNEED);
+	SYS_ASSERT(0, result != -1);
+}
 
 sys_msecs_t sysGetWallTime() {
 	timeval walltime;